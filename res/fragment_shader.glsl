@@ -4,26 +4,155 @@ uniform uvec2 windowSize;
 uniform double zoomScale;
 uniform dvec2 numberStart;
 uniform uint maxIterations = 400;
+uniform usampler2D iterationTexture; // Iteration counts computed on the CPU, only read when rendering with the CPU engine
+uniform vec4 iterationTextureArea = vec4(0.0, 0.0, 1.0, 1.0); // Part of the texture the window shows (left, top, width, height), scales frames of another zoom
+uniform dvec2 centerReal; // View center as double-double (high, low), only read when GPU_PRECISION is 3
+uniform dvec2 centerImag;
 
 out vec4 fragColor;
 
-uint calcMandel(double startReal, double startImag) {
+// GPU_PRECISION picks the number format of the iteration: 0 float, 1 double-single, 2 double, 3 double-double.
+// The app selects the cheapest one that still resolves the pixels, see ViewState::cheapestShaderPrecision.
 
-	double real = startReal;
-	double imag = startImag;
+#if GPU_PRECISION == 0 || GPU_PRECISION == 2
+
+#if GPU_PRECISION == 0
+#define REAL float
+#else
+#define REAL double
+#endif
+
+// Main cardioid and period-2 bulb, like isInMainCardioidOrBulb in src/core/iteration_kernel.cpp
+bool isInMainCardioidOrBulb(REAL real, REAL imag) {
+	REAL imagSquared = imag * imag;
+	REAL shifted = real - 0.25;
+	REAL q = shifted * shifted + imagSquared;
+	REAL bulb = real + 1;
+	return q * (q + shifted) <= 0.25 * imagSquared || bulb * bulb + imagSquared <= 0.0625;
+}
+
+uint calcMandel(REAL startReal, REAL startImag) {
+
+	if (isInMainCardioidOrBulb(startReal, startImag)) {
+		return 0;
+	}
+
+	REAL real = startReal;
+	REAL imag = startImag;
+
+	// Brent's cycle detection: an orbit that comes back exactly to the value saved at 1, 2, 4, 8, ... never escapes
+	REAL checkReal = real;
+	REAL checkImag = imag;
+	int nextCheck = 1;
 
 	for (int n = 1; n < maxIterations + 1; n++) {
 		if ((real * real) + (imag * imag) > 4) {
 			return n;
 		}
-		double realTemp = real;
+		REAL realTemp = real;
 
 		real = (real * real) - (imag * imag) + startReal;
 		imag = 2 * realTemp * imag + startImag;
+
+		if (real == checkReal && imag == checkImag) {
+			return 0;
+		}
+		if (n == nextCheck) {
+			checkReal = real;
+			checkImag = imag;
+			nextCheck *= 2;
+		}
 	}
 	return 0;
 }
 
+#else
+
+// Unevaluated sums (high, low) of two floats (double-single, about 48 bits) or two doubles (double-double, about
+// 106 bits), like src/core/double_double.h. The error terms only survive exact IEEE rounding, "precise" keeps the
+// compiler from fusing or reordering the operations.
+
+#if GPU_PRECISION == 1
+#define REAL float
+#define PAIR vec2
+#else
+#define REAL double
+#define PAIR dvec2
+#endif
+
+PAIR quickTwoSum(REAL a, REAL b) {
+	precise REAL sum = a + b;
+	precise REAL error = b - (sum - a);
+	return PAIR(sum, error);
+}
+
+PAIR twoSum(REAL a, REAL b) {
+	precise REAL sum = a + b;
+	precise REAL bVirtual = sum - a;
+	precise REAL error = (a - (sum - bVirtual)) + (b - bVirtual);
+	return PAIR(sum, error);
+}
+
+PAIR twoProduct(REAL a, REAL b) {
+	precise REAL product = a * b;
+	precise REAL error = fma(a, b, -product);
+	return PAIR(product, error);
+}
+
+PAIR pairAdd(PAIR a, PAIR b) {
+	PAIR sum = twoSum(a.x, b.x);
+	PAIR error = twoSum(a.y, b.y);
+	sum = quickTwoSum(sum.x, sum.y + error.x);
+	return quickTwoSum(sum.x, sum.y + error.y);
+}
+
+PAIR pairMul(PAIR a, PAIR b) {
+	PAIR product = twoProduct(a.x, b.x);
+	precise REAL cross = a.x * b.y + a.y * b.x;
+	return quickTwoSum(product.x, product.y + cross);
+}
+
+PAIR pairSquare(PAIR a) {
+	PAIR product = twoProduct(a.x, a.x);
+	precise REAL cross = 2 * a.x * a.y;
+	return quickTwoSum(product.x, product.y + cross);
+}
+
+uint calcMandel(PAIR startReal, PAIR startImag) {
+
+	PAIR real = startReal;
+	PAIR imag = startImag;
+
+	// Cycle detection as in the single-number kernel, on both parts. There is no cardioid test here: these precisions
+	// only run where the high part alone no longer resolves the pixels, so it would misjudge points at the edge.
+	PAIR checkReal = real;
+	PAIR checkImag = imag;
+	int nextCheck = 1;
+
+	for (int n = 1; n < maxIterations + 1; n++) {
+		// The low parts do not change whether the point is outside the escape radius
+		if ((real.x * real.x) + (imag.x * imag.x) > 4) {
+			return n;
+		}
+		PAIR realTemp = real;
+
+		real = pairAdd(pairAdd(pairSquare(real), -pairSquare(imag)), startReal);
+		imag = pairAdd(2 * pairMul(realTemp, imag), startImag);
+
+		if (real == checkReal && imag == checkImag) {
+			return 0;
+		}
+		if (n == nextCheck) {
+			checkReal = real;
+			checkImag = imag;
+			nextCheck *= 2;
+		}
+	}
+	return 0;
+}
+
+#endif
+
 #if FLOW_COLOR_TYPE == 0
 
 vec4 flowColor(uint index) {
@@ -191,9 +320,28 @@ vec4 flowColor(uint index) {
 #endif
 
 void main() {
+#if USE_ITERATION_TEXTURE == 1
+	// The texture is stored top row first and may still have the size of the window from when it was computed
+	vec2 position = gl_FragCoord.xy / vec2(windowSize);
+	uint calc = texture(iterationTexture, iterationTextureArea.xy + vec2(position.x, 1.0 - position.y) * iterationTextureArea.zw).r;
+#elif GPU_PRECISION == 3
+	// Too deep for double coordinates: the offset from the center fits into a double, only the sum needs the low part
+	double offsetReal = zoomScale * (double(gl_FragCoord.x) + 0.5 - 0.5 * windowSize.x) / windowSize.x;
+	double offsetImag = zoomScale * (double(gl_FragCoord.y) + 0.5 - 0.5 * windowSize.y) / windowSize.x;
+
+	uint calc = calcMandel(pairAdd(centerReal, dvec2(offsetReal, 0)), pairAdd(centerImag, dvec2(offsetImag, 0)));
+#else
 	double real = zoomScale * (double(gl_FragCoord.x) + 0.5) / windowSize.x + numberStart.x;
 	double imag = (zoomScale * (double(gl_FragCoord.y) + 0.5) + numberStart.y * windowSize.y) / windowSize.x;
-	
-	uint calc = calcMandel(real, imag);
+
+#if GPU_PRECISION == 1
+	// The coordinates are only computed once per pixel, double is cheap there, the iteration runs in floats
+	float realHigh = float(real);
+	float imagHigh = float(imag);
+	uint calc = calcMandel(vec2(realHigh, float(real - realHigh)), vec2(imagHigh, float(imag - imagHigh)));
+#else
+	uint calc = calcMandel(REAL(real), REAL(imag));
+#endif
+#endif
 	fragColor = flowColor(calc);
 }
@@ -0,0 +1,413 @@
+#include "big_fixed.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+constexpr int LIMB_BITS = 32;
+constexpr std::uint64_t LIMB_BASE = std::uint64_t{1} << LIMB_BITS;
+constexpr double DIGIT_BITS = 3.321928094887362; // log2(10), bits per decimal digit
+
+/**
+ * Schoolbook product of two magnitudes of the same length, returns 2 * n limbs
+ */
+std::vector<std::uint32_t> multiplyMagnitudes(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b) {
+    std::size_t n = a.size();
+    std::vector<std::uint32_t> product(2 * n, 0);
+    for (std::size_t i = 0; i < n; i++) {
+        if (a[i] == 0)
+            continue;
+        std::uint64_t carry = 0;
+        for (std::size_t j = 0; j < n; j++) {
+            std::uint64_t current = std::uint64_t{a[i]} * b[j] + product[i + j] + carry;
+            product[i + j] = static_cast<std::uint32_t>(current);
+            carry = current >> LIMB_BITS;
+        }
+        product[i + n] = static_cast<std::uint32_t>(carry);
+    }
+    return product;
+}
+
+/**
+ * Schoolbook square, every cross product is only computed once, returns 2 * n limbs
+ */
+std::vector<std::uint32_t> squareSchoolbook(const std::uint32_t* a, std::size_t n) {
+    std::vector<std::uint32_t> product(2 * n, 0);
+
+    // Cross products a[i] * a[j] with i < j
+    for (std::size_t i = 0; i < n; i++) {
+        if (a[i] == 0)
+            continue;
+        std::uint64_t carry = 0;
+        for (std::size_t j = i + 1; j < n; j++) {
+            std::uint64_t current = std::uint64_t{a[i]} * a[j] + product[i + j] + carry;
+            product[i + j] = static_cast<std::uint32_t>(current);
+            carry = current >> LIMB_BITS;
+        }
+        product[i + n] = static_cast<std::uint32_t>(carry);
+    }
+
+    // Double them
+    std::uint32_t topBit = 0;
+    for (std::size_t i = 0; i < 2 * n; i++) {
+        std::uint32_t next = product[i] >> (LIMB_BITS - 1);
+        product[i] = (product[i] << 1) | topBit;
+        topBit = next;
+    }
+
+    // Add the squares a[i] * a[i]
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        std::uint64_t square = std::uint64_t{a[i]} * a[i];
+        std::uint64_t low = std::uint64_t{product[2 * i]} + static_cast<std::uint32_t>(square) + carry;
+        product[2 * i] = static_cast<std::uint32_t>(low);
+        std::uint64_t high = std::uint64_t{product[2 * i + 1]} + (square >> LIMB_BITS) + (low >> LIMB_BITS);
+        product[2 * i + 1] = static_cast<std::uint32_t>(high);
+        carry = high >> LIMB_BITS;
+    }
+    return product;
+}
+
+/**
+ * Adds `value` to `target` starting at limb `offset`, the carry must not run past the end of `target`
+ */
+void addAt(std::vector<std::uint32_t>& target, const std::vector<std::uint32_t>& value, std::size_t offset) {
+    std::uint64_t carry = 0;
+    std::size_t i = 0;
+    for (; i < value.size(); i++) {
+        std::uint64_t sum = std::uint64_t{target[offset + i]} + value[i] + carry;
+        target[offset + i] = static_cast<std::uint32_t>(sum);
+        carry = sum >> LIMB_BITS;
+    }
+    for (; carry != 0 && offset + i < target.size(); i++) {
+        std::uint64_t sum = std::uint64_t{target[offset + i]} + carry;
+        target[offset + i] = static_cast<std::uint32_t>(sum);
+        carry = sum >> LIMB_BITS;
+    }
+}
+
+/**
+ * Subtracts `value` from `target`, `target` has to be the larger number
+ */
+void subtractFrom(std::vector<std::uint32_t>& target, const std::vector<std::uint32_t>& value) {
+    std::uint32_t borrow = 0;
+    for (std::size_t i = 0; i < target.size(); i++) {
+        std::uint64_t subtrahend = std::uint64_t{i < value.size() ? value[i] : 0} + borrow;
+        borrow = target[i] < subtrahend ? 1 : 0;
+        target[i] = static_cast<std::uint32_t>(target[i] - subtrahend);
+    }
+}
+
+/**
+ * Square of a magnitude, returns 2 * n limbs
+ *
+ * Long numbers are squared with Karatsuba: for a = high * B + low, 2 * high * low = (high + low)^2 - high^2 - low^2,
+ * so three squares of half the length replace four products.
+ */
+std::vector<std::uint32_t> squareMagnitude(const std::uint32_t* a, std::size_t n) {
+    constexpr std::size_t KARATSUBA_THRESHOLD = 40; // Limbs, below this the schoolbook square is faster
+    if (n < KARATSUBA_THRESHOLD)
+        return squareSchoolbook(a, n);
+
+    std::size_t half = n / 2;
+    std::size_t highSize = n - half;
+    std::vector<std::uint32_t> lowSquared = squareMagnitude(a, half);
+    std::vector<std::uint32_t> highSquared = squareMagnitude(a + half, highSize);
+
+    std::vector<std::uint32_t> sum(a + half, a + n);
+    sum.push_back(0);
+    addAt(sum, std::vector<std::uint32_t>(a, a + half), 0);
+    std::vector<std::uint32_t> middle = squareMagnitude(sum.data(), sum.size());
+    subtractFrom(middle, lowSquared);
+    subtractFrom(middle, highSquared);
+
+    std::vector<std::uint32_t> product(2 * n, 0);
+    std::copy(lowSquared.begin(), lowSquared.end(), product.begin());
+    std::copy(highSquared.begin(), highSquared.end(), product.begin() + static_cast<std::ptrdiff_t>(2 * half));
+    while (middle.size() > 2 * n - half) // The top limbs of the middle term are zero
+        middle.pop_back();
+    addAt(product, middle, half);
+    return product;
+}
+
+} // namespace
+
+int BigFixed::limbsForBits(int bits) {
+    return std::max(1, (bits + LIMB_BITS - 1) / LIMB_BITS);
+}
+
+BigFixed::BigFixed(long double value, int fractionLimbs) : limbs(static_cast<std::size_t>(std::max(0, fractionLimbs)) + 1, 0) {
+    negative = value < 0.0L;
+    long double magnitude = std::fabs(value);
+
+    long double integerPart = std::floor(magnitude);
+    limbs.back() = static_cast<std::uint32_t>(integerPart);
+    long double fraction = magnitude - integerPart;
+    for (std::size_t i = limbs.size() - 1; i-- > 0 && fraction != 0.0L;) {
+        fraction = std::ldexp(fraction, LIMB_BITS); // exact
+        long double digit = std::floor(fraction);
+        limbs[i] = static_cast<std::uint32_t>(digit);
+        fraction -= digit;
+    }
+    trimNegativeZero();
+}
+
+BigFixed BigFixed::fromString(const std::string& text, int fractionLimbs) {
+    // Split into sign, digits and decimal exponent, so that value = 0.digits * 10^pointPosition
+    std::size_t pos = 0;
+    bool isNegative = false;
+    if (pos < text.size() && (text[pos] == '-' || text[pos] == '+'))
+        isNegative = text[pos++] == '-';
+
+    std::string digits;
+    long pointPosition = 0;
+    bool seenPoint = false;
+    for (; pos < text.size(); pos++) {
+        char c = text[pos];
+        if (std::isdigit(static_cast<unsigned char>(c))) {
+            digits.push_back(c);
+            if (!seenPoint)
+                pointPosition++;
+        }
+        else if (c == '.' && !seenPoint)
+            seenPoint = true;
+        else
+            break;
+    }
+    if (digits.empty())
+        throw std::invalid_argument("BigFixed: not a number: " + text);
+
+    if (pos < text.size()) {
+        if (text[pos] != 'e' && text[pos] != 'E')
+            throw std::invalid_argument("BigFixed: not a number: " + text);
+        std::size_t parsed = 0;
+        pointPosition += std::stol(text.substr(pos + 1), &parsed);
+        if (pos + 1 + parsed != text.size())
+            throw std::invalid_argument("BigFixed: not a number: " + text);
+    }
+
+    if (fractionLimbs < 0) {
+        long fractionDigits = std::max(0L, static_cast<long>(digits.size()) - pointPosition);
+        fractionLimbs = limbsForBits(static_cast<int>(std::ceil(static_cast<double>(fractionDigits) * DIGIT_BITS)));
+    }
+
+    // One guard limb absorbs the truncation errors of the repeated divisions
+    BigFixed result{0.0L, fractionLimbs + 1};
+    for (std::size_t i = digits.size(); i-- > 0;) {
+        result.limbs.back() += static_cast<std::uint32_t>(digits[i] - '0');
+        result.divideSmall(10);
+    }
+    for (; pointPosition > 0; pointPosition--)
+        result.multiplySmall(10);
+    for (; pointPosition < 0 && !result.isZero(); pointPosition++)
+        result.divideSmall(10);
+
+    // Round to nearest, so that printing with `toString()` and parsing again gives back the same number
+    bool roundUp = result.limbs.front() >= (std::uint32_t{1} << (LIMB_BITS - 1));
+    result = result.withPrecision(fractionLimbs);
+    for (std::size_t i = 0; roundUp && i < result.limbs.size(); i++)
+        roundUp = ++result.limbs[i] == 0;
+
+    result.negative = isNegative;
+    result.trimNegativeZero();
+    return result;
+}
+
+std::string BigFixed::toString(int fractionDigits) const {
+    if (fractionDigits < 0) // One digit more than the fraction limbs hold
+        fractionDigits = static_cast<int>(std::ceil(getFractionLimbs() * LIMB_BITS / DIGIT_BITS)) + 1;
+
+    std::string text = negative ? "-" : "";
+    text += std::to_string(limbs.back());
+    if (fractionDigits <= 0)
+        return text;
+
+    text += '.';
+    BigFixed fraction = *this;
+    fraction.negative = false;
+    for (int i = 0; i < fractionDigits; i++) {
+        fraction.limbs.back() = 0;
+        fraction.multiplySmall(10);
+        text += static_cast<char>('0' + fraction.limbs.back());
+    }
+    return text;
+}
+
+long double BigFixed::toLongDouble() const {
+    // The 3 most significant non-zero limbs already hold more bits than a long double
+    long double value = 0.0L;
+    int used = 0;
+    for (std::size_t i = limbs.size(); i-- > 0 && used < 3;) {
+        if (used == 0 && limbs[i] == 0)
+            continue;
+        value += std::ldexp(static_cast<long double>(limbs[i]), LIMB_BITS * (static_cast<int>(i) - getFractionLimbs()));
+        used++;
+    }
+    return negative ? -value : value;
+}
+
+bool BigFixed::isZero() const {
+    return std::all_of(limbs.begin(), limbs.end(), [](std::uint32_t limb) { return limb == 0; });
+}
+
+BigFixed BigFixed::withPrecision(int fractionLimbs) const {
+    fractionLimbs = std::max(0, fractionLimbs);
+    int difference = fractionLimbs - getFractionLimbs();
+    BigFixed result = *this;
+    if (difference > 0)
+        result.limbs.insert(result.limbs.begin(), static_cast<std::size_t>(difference), 0);
+    else if (difference < 0)
+        result.limbs.erase(result.limbs.begin(), result.limbs.begin() + (-difference));
+    result.trimNegativeZero();
+    return result;
+}
+
+BigFixed BigFixed::operator-() const {
+    BigFixed result = *this;
+    result.negative = !negative;
+    result.trimNegativeZero();
+    return result;
+}
+
+BigFixed BigFixed::operator+(const BigFixed& other) const {
+    int precision = std::max(getFractionLimbs(), other.getFractionLimbs());
+    BigFixed a = withPrecision(precision);
+    BigFixed b = other.withPrecision(precision);
+
+    if (a.negative == b.negative) {
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < a.limbs.size(); i++) {
+            std::uint64_t sum = std::uint64_t{a.limbs[i]} + b.limbs[i] + carry;
+            a.limbs[i] = static_cast<std::uint32_t>(sum);
+            carry = sum >> LIMB_BITS;
+        }
+        return a; // An overflow of the integer limb is dropped
+    }
+
+    // Different signs: subtract the smaller magnitude from the larger one
+    if (compareMagnitude(a.limbs, b.limbs) < 0)
+        std::swap(a, b);
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i < a.limbs.size(); i++) {
+        std::int64_t difference = std::int64_t{a.limbs[i]} - b.limbs[i] - borrow;
+        borrow = difference < 0 ? 1 : 0;
+        a.limbs[i] = static_cast<std::uint32_t>(difference + (borrow ? static_cast<std::int64_t>(LIMB_BASE) : 0));
+    }
+    a.trimNegativeZero();
+    return a;
+}
+
+BigFixed BigFixed::operator-(const BigFixed& other) const {
+    return *this + (-other);
+}
+
+BigFixed BigFixed::operator*(const BigFixed& other) const {
+    int precision = std::max(getFractionLimbs(), other.getFractionLimbs());
+    BigFixed a = withPrecision(precision);
+    BigFixed b = other.withPrecision(precision);
+
+    std::vector<std::uint32_t> product = multiplyMagnitudes(a.limbs, b.limbs);
+    std::vector<std::uint32_t> result(product.begin() + precision, product.begin() + precision + static_cast<std::ptrdiff_t>(a.limbs.size()));
+    return fromMagnitude(std::move(result), a.negative != b.negative);
+}
+
+BigFixed BigFixed::square() const {
+    int precision = getFractionLimbs();
+    std::vector<std::uint32_t> product = squareMagnitude(limbs.data(), limbs.size());
+    std::vector<std::uint32_t> result(product.begin() + precision, product.begin() + precision + static_cast<std::ptrdiff_t>(limbs.size()));
+    return fromMagnitude(std::move(result), false);
+}
+
+BigFixed BigFixed::scaledByPowerOfTwo(int exponent) const {
+    BigFixed result = *this;
+    std::vector<std::uint32_t>& values = result.limbs;
+    std::size_t n = values.size();
+
+    if (exponent > 0) {
+        auto limbShift = static_cast<std::size_t>(exponent / LIMB_BITS);
+        int bitShift = exponent % LIMB_BITS;
+        for (std::size_t i = n; i-- > 0;) {
+            std::uint64_t high = i >= limbShift ? values[i - limbShift] : 0;
+            std::uint64_t low = i >= limbShift + 1 ? values[i - limbShift - 1] : 0;
+            values[i] = static_cast<std::uint32_t>(((high << LIMB_BITS | low) << bitShift) >> LIMB_BITS);
+        }
+    }
+    else if (exponent < 0) {
+        auto limbShift = static_cast<std::size_t>(-exponent / LIMB_BITS);
+        int bitShift = -exponent % LIMB_BITS;
+        for (std::size_t i = 0; i < n; i++) {
+            std::uint64_t low = i + limbShift < n ? values[i + limbShift] : 0;
+            std::uint64_t high = i + limbShift + 1 < n ? values[i + limbShift + 1] : 0;
+            values[i] = static_cast<std::uint32_t>((high << LIMB_BITS | low) >> bitShift);
+        }
+    }
+    result.trimNegativeZero();
+    return result;
+}
+
+BigFixed BigFixed::multipliedBy(std::uint32_t factor) const {
+    BigFixed result = *this;
+    result.multiplySmall(factor);
+    result.trimNegativeZero();
+    return result;
+}
+
+BigFixed BigFixed::dividedBy(std::uint32_t divisor) const {
+    BigFixed result = *this;
+    result.divideSmall(divisor);
+    result.trimNegativeZero();
+    return result;
+}
+
+int BigFixed::compare(const BigFixed& other) const {
+    int precision = std::max(getFractionLimbs(), other.getFractionLimbs());
+    BigFixed a = withPrecision(precision);
+    BigFixed b = other.withPrecision(precision);
+
+    if (a.negative != b.negative)
+        return a.negative ? -1 : 1;
+    int magnitude = compareMagnitude(a.limbs, b.limbs);
+    return a.negative ? -magnitude : magnitude;
+}
+
+void BigFixed::trimNegativeZero() {
+    if (negative && isZero())
+        negative = false;
+}
+
+void BigFixed::multiplySmall(std::uint32_t factor) {
+    std::uint64_t carry = 0;
+    for (std::uint32_t& limb : limbs) {
+        std::uint64_t current = std::uint64_t{limb} * factor + carry;
+        limb = static_cast<std::uint32_t>(current);
+        carry = current >> LIMB_BITS;
+    }
+}
+
+void BigFixed::divideSmall(std::uint32_t divisor) {
+    std::uint64_t remainder = 0;
+    for (std::size_t i = limbs.size(); i-- > 0;) {
+        std::uint64_t current = (remainder << LIMB_BITS) | limbs[i];
+        limbs[i] = static_cast<std::uint32_t>(current / divisor);
+        remainder = current % divisor;
+    }
+}
+
+BigFixed BigFixed::fromMagnitude(std::vector<std::uint32_t> limbs, bool negative) {
+    BigFixed result;
+    result.limbs = std::move(limbs);
+    result.negative = negative;
+    result.trimNegativeZero();
+    return result;
+}
+
+int BigFixed::compareMagnitude(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b) {
+    for (std::size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
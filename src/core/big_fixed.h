@@ -0,0 +1,112 @@
+#pragma once
+#ifndef MANDELBROT_BIGFIXED_INCLUDED
+#define MANDELBROT_BIGFIXED_INCLUDED
+
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Signed multi-limb fixed-point number, used where `long double` runs out of precision (deep zoom reference orbits)
+ *
+ * The magnitude is stored in 32 bit limbs, least significant first. The last limb is the integer part,
+ * all limbs before it are fraction, so the value is `sum(limbs[i] * 2^(32 * (i - fractionLimbs)))`.
+ * The integer part is only one limb, which is plenty for points of the Mandelbrot set and their orbits.
+ * Results of operations on numbers of different precision get the higher of the two precisions.
+ */
+class BigFixed {
+
+protected:
+    std::vector<std::uint32_t> limbs;
+    bool negative = false;
+
+public:
+    /**
+     * @return The number of fraction limbs needed to represent `bits` fraction bits
+     */
+    static int limbsForBits(int bits);
+
+    BigFixed() : limbs(1, 0) {}
+    BigFixed(long double value, int fractionLimbs);
+
+    /**
+     * Parses a decimal number like "-0.75", "1.5e-30" or "123", rounded to the nearest number of the precision
+     *
+     * @param fractionLimbs Precision of the result, -1 picks enough limbs for every digit of `text`
+     * @throws `std::invalid_argument` if `text` is not a number
+     */
+    static BigFixed fromString(const std::string& text, int fractionLimbs = -1);
+
+    /**
+     * @param fractionDigits Number of decimal digits after the point (truncated, not rounded),
+     *                       -1 prints one digit more than the precision holds, so `fromString` with the
+     *                       same precision gives back the same number
+     */
+    std::string toString(int fractionDigits = -1) const;
+
+    long double toLongDouble() const;
+    inline double toDouble() const { return static_cast<double>(toLongDouble()); }
+
+    inline int getFractionLimbs() const { return static_cast<int>(limbs.size()) - 1; }
+    inline bool isNegative() const { return negative; }
+    bool isZero() const;
+
+    /**
+     * @return A copy with `fractionLimbs` fraction limbs, extra limbs are zero, dropped limbs are truncated
+     */
+    BigFixed withPrecision(int fractionLimbs) const;
+
+    BigFixed operator-() const;
+    BigFixed operator+(const BigFixed& other) const;
+    BigFixed operator-(const BigFixed& other) const;
+    BigFixed operator*(const BigFixed& other) const;
+    BigFixed square() const;
+
+    /**
+     * Multiplies or divides by 2^`exponent` (exact as long as no bits are shifted out)
+     */
+    BigFixed scaledByPowerOfTwo(int exponent) const;
+
+    /**
+     * Multiplies by a small integer (exact as long as the integer part does not overflow)
+     */
+    BigFixed multipliedBy(std::uint32_t factor) const;
+
+    /**
+     * Divides by a small integer, the result is truncated to the precision of this number
+     */
+    BigFixed dividedBy(std::uint32_t divisor) const;
+
+    inline BigFixed& operator+=(const BigFixed& other) { return *this = *this + other; }
+    inline BigFixed& operator-=(const BigFixed& other) { return *this = *this - other; }
+    inline BigFixed& operator*=(const BigFixed& other) { return *this = *this * other; }
+
+    /**
+     * @return Negative, zero or positive, like `strcmp`
+     */
+    int compare(const BigFixed& other) const;
+    inline bool operator==(const BigFixed& other) const { return compare(other) == 0; }
+    inline std::strong_ordering operator<=>(const BigFixed& other) const { return compare(other) <=> 0; }
+
+protected:
+    void trimNegativeZero();
+    void multiplySmall(std::uint32_t factor);
+    void divideSmall(std::uint32_t divisor);
+    static BigFixed fromMagnitude(std::vector<std::uint32_t> limbs, bool negative);
+    static int compareMagnitude(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b);
+
+};
+
+/**
+ * Complex number made of two `BigFixed`
+ */
+struct ComplexFixed {
+    BigFixed real;
+    BigFixed imag;
+
+    bool operator==(const ComplexFixed& other) const = default;
+    auto operator<=>(const ComplexFixed& other) const = default;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "bla_table.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+void BlaTable::build(const ReferenceOrbit& reference, double deltaRadius) {
+    levels.clear();
+    if (reference.size() < 3)
+        return;
+
+    // A step from m needs Z_m and lands on m + 1, which has to be part of the orbit
+    const double* orbitReal = reference.getReal();
+    const double* orbitImag = reference.getImag();
+    std::vector<BlaStep> single(reference.size() - 2);
+    for (std::size_t j = 0; j < single.size(); j++) {
+        std::size_t m = j + 1;
+        single[j].aReal = 2.0 * orbitReal[m];
+        single[j].aImag = 2.0 * orbitImag[m];
+        single[j].bReal = 1.0;
+        single[j].radius = PRECISION * std::hypot(orbitReal[m], orbitImag[m]);
+    }
+    levels.push_back(std::move(single));
+
+    while (levels.back().size() >= 2) {
+        const std::vector<BlaStep>& lower = levels.back();
+        std::vector<BlaStep> merged(lower.size() / 2);
+        for (std::size_t j = 0; j < merged.size(); j++) {
+            // First x, then y: d'' = a_y (a_x d + b_x delta) + b_y delta
+            const BlaStep& x = lower[2 * j];
+            const BlaStep& y = lower[2 * j + 1];
+            BlaStep& z = merged[j];
+            z.aReal = y.aReal * x.aReal - y.aImag * x.aImag;
+            z.aImag = y.aReal * x.aImag + y.aImag * x.aReal;
+            z.bReal = y.aReal * x.bReal - y.aImag * x.bImag + y.bReal;
+            z.bImag = y.aReal * x.bImag + y.aImag * x.bReal + y.bImag;
+
+            // After x the delta is at most |a_x| |d| + |b_x| |delta|, which has to stay inside the radius of y
+            double aMagnitude = std::hypot(x.aReal, x.aImag);
+            double yRadius = aMagnitude > 0.0 ? std::max(0.0, (y.radius - std::hypot(x.bReal, x.bImag) * deltaRadius) / aMagnitude) : 0.0;
+            z.radius = std::min(x.radius, yRadius);
+        }
+        levels.push_back(std::move(merged));
+    }
+}
+
+std::uint32_t BlaTable::lookupMerged(std::size_t m, double deltaNorm, std::uint32_t maxSkip, const BlaStep*& step) const {
+    // Level l only has steps starting at 1 + j * 2^l. A merged step is never valid for a larger delta than
+    // the first step it contains, so the search can go up from level 0 and stop at the first level that fails.
+    std::size_t offset = m - 1;
+    std::size_t highestLevel = offset == 0 ? levels.size() - 1 : std::min<std::size_t>(levels.size() - 1, static_cast<std::size_t>(std::countr_zero(offset)));
+    std::uint32_t skip = 0;
+    for (std::size_t level = 0; level <= highestLevel; level++) {
+        std::size_t index = offset >> level;
+        if ((std::uint32_t{1} << level) > maxSkip || index >= levels[level].size())
+            break;
+
+        const BlaStep& candidate = levels[level][index];
+        if (deltaNorm >= candidate.radius * candidate.radius)
+            break;
+        step = &candidate;
+        skip = std::uint32_t{1} << level;
+    }
+    return skip;
+}
+
+std::vector<std::size_t> BlaTable::getLevelBytes() const {
+    std::vector<std::size_t> bytes;
+    for (const std::vector<BlaStep>& level : levels)
+        bytes.push_back(level.size() * sizeof(BlaStep));
+    return bytes;
+}
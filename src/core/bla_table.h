@@ -0,0 +1,77 @@
+#pragma once
+#ifndef MANDELBROT_BLATABLE_INCLUDED
+#define MANDELBROT_BLATABLE_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "reference_orbit.h"
+
+/**
+ * Bilinear approximation of `2^level` perturbation steps: `d_(m+2^level) = a * d_m + b * delta`, valid while `|d_m| < radius`
+ */
+struct BlaStep {
+    double aReal = 0.0;
+    double aImag = 0.0;
+    double bReal = 0.0;
+    double bImag = 0.0;
+    double radius = 0.0;
+};
+
+/**
+ * Hierarchy of bilinear approximations (BLA) over a reference orbit
+ *
+ * Level 0 holds one step per orbit point (`a = 2 Z_m`, `b = 1`, valid while `d^2` is negligible next to `2 Z_m d`).
+ * Level `l + 1` merges pairs of neighbouring level `l` steps, so a pixel whose delta is small enough can jump
+ * `2^l` iterations with a single complex multiply-add. Unlike `SeriesApproximation` the table works from any
+ * orbit position, which keeps it useful after the pixel rebased onto the start of the orbit.
+ */
+class BlaTable {
+
+protected:
+    std::vector<std::vector<BlaStep>> levels; // levels[l][j] starts at orbit index 1 + j * 2^l
+
+public:
+    /**
+     * Relative size of the dropped `d^2` term up to which a step is considered exact enough (the unit roundoff of `double`)
+     */
+    static constexpr double PRECISION = 0x1p-53;
+
+    /**
+     * @param reference Reference orbit the table is built for
+     * @param deltaRadius Largest pixel offset `|delta|` of the frame, needed to bound the `b * delta` part of merged steps
+     */
+    void build(const ReferenceOrbit& reference, double deltaRadius);
+
+    /**
+     * Finds the longest step that can be taken from orbit index `m`
+     *
+     * @param deltaNorm `|d_m|^2`
+     * @param maxSkip Largest number of iterations the step may skip
+     * @param step Receives the step if one was found
+     * @return Number of iterations the step skips, 0 if there is no valid step
+     */
+    inline std::uint32_t lookup(std::size_t m, double deltaNorm, std::uint32_t maxSkip, const BlaStep*& step) const {
+        // Most lookups fail on the single step already, that check is kept inline for the pixel loops
+        if (m == 0 || levels.empty() || m > levels[0].size() || deltaNorm >= levels[0][m - 1].radius * levels[0][m - 1].radius)
+            return 0;
+        return lookupMerged(m, deltaNorm, maxSkip, step);
+    }
+
+    inline std::size_t getLevelCount() const { return levels.size(); }
+
+    /**
+     * @return Memory used by each level in bytes, level 0 first
+     */
+    std::vector<std::size_t> getLevelBytes() const;
+
+protected:
+    /**
+     * `lookup` once the single step from `m` is known to be valid
+     */
+    std::uint32_t lookupMerged(std::size_t m, double deltaNorm, std::uint32_t maxSkip, const BlaStep*& step) const;
+
+};
+
+#endif
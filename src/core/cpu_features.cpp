@@ -0,0 +1,91 @@
+#include "cpu_features.h"
+
+#if defined(MANDELBROT_X86_KERNELS) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#if defined(MANDELBROT_X86_KERNELS)
+
+#if defined(_MSC_VER)
+
+bool osSavesRegisters(unsigned long long mask) {
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    return osxsave && (_xgetbv(0) & mask) == mask;
+}
+
+bool cpuHasAvx2() {
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0 && osSavesRegisters(0x6); // XMM and YMM state
+}
+
+bool cpuHasAvx512() {
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0 && osSavesRegisters(0xe6); // XMM, YMM, opmask and ZMM state
+}
+
+#else
+
+// GCC and Clang also check that the OS saves the wider registers
+bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+bool cpuHasAvx512() { return __builtin_cpu_supports("avx512f"); }
+
+#endif
+
+#endif
+
+} // namespace
+
+bool isIsaSupported(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Scalar:
+            return true;
+#if defined(MANDELBROT_X86_KERNELS)
+        case KernelIsa::Avx2: {
+            static const bool supported = cpuHasAvx2();
+            return supported;
+        }
+        case KernelIsa::Avx512: {
+            static const bool supported = cpuHasAvx512();
+            return supported;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+KernelIsa bestSupportedIsa() {
+    if (isIsaSupported(KernelIsa::Avx512))
+        return KernelIsa::Avx512;
+    if (isIsaSupported(KernelIsa::Avx2))
+        return KernelIsa::Avx2;
+    return KernelIsa::Scalar;
+}
+
+std::vector<KernelIsa> supportedIsas() {
+    std::vector<KernelIsa> isas;
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::Avx2, KernelIsa::Avx512}) {
+        if (isIsaSupported(isa))
+            isas.push_back(isa);
+    }
+    return isas;
+}
+
+const char* isaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::Scalar:
+            return "scalar";
+        case KernelIsa::Avx2:
+            return "avx2";
+        case KernelIsa::Avx512:
+            return "avx512";
+    }
+    return "unknown";
+}
@@ -0,0 +1,33 @@
+#pragma once
+#ifndef MANDELBROT_CPUFEATURES_INCLUDED
+#define MANDELBROT_CPUFEATURES_INCLUDED
+
+#include <vector>
+
+/**
+ * Instruction set levels the iteration kernels are compiled for
+ */
+enum class KernelIsa {
+    Scalar = 0,
+    Avx2 = 1,   // 4 doubles per vector
+    Avx512 = 2, // 8 doubles per vector
+};
+
+/**
+ * @return Returns `true` if the kernel for `isa` was compiled in and the running CPU (and OS) supports it
+ */
+bool isIsaSupported(KernelIsa isa);
+
+/**
+ * @return The widest instruction set level that `isIsaSupported`
+ */
+KernelIsa bestSupportedIsa();
+
+/**
+ * @return All instruction set levels that `isIsaSupported`, narrowest first
+ */
+std::vector<KernelIsa> supportedIsas();
+
+const char* isaName(KernelIsa isa);
+
+#endif
@@ -0,0 +1,166 @@
+#include "distance_estimate.h"
+
+#include <cmath>
+
+#include "iteration_kernel.h"
+
+namespace {
+
+struct Complex {
+    double real;
+    double imag;
+
+    inline Complex operator+(const Complex& other) const { return {real + other.real, imag + other.imag}; }
+    inline Complex operator-(const Complex& other) const { return {real - other.real, imag - other.imag}; }
+    inline Complex operator*(const Complex& other) const { return {real * other.real - imag * other.imag, real * other.imag + imag * other.real}; }
+    inline Complex operator*(double factor) const { return {real * factor, imag * factor}; }
+    inline Complex operator/(const Complex& other) const {
+        double divisor = other.norm();
+        return {(real * other.real + imag * other.imag) / divisor, (imag * other.real - real * other.imag) / divisor};
+    }
+    inline double norm() const { return real * real + imag * imag; }
+    inline double abs() const { return std::sqrt(norm()); }
+
+    /**
+     * @return The square root with a non-negative real part
+     */
+    inline Complex sqrt() const {
+        double magnitude = abs();
+        double rootReal = std::sqrt(0.5 * (magnitude + real));
+        double rootImag = std::sqrt(0.5 * (magnitude - real));
+        return {rootReal, imag < 0.0 ? -rootImag : rootImag};
+    }
+};
+
+// Escaped orbits are followed up to this |Z|^2, the estimate is only exact in the limit of a large escape radius
+constexpr double ESTIMATE_RADIUS_SQUARED = 1e16;
+constexpr unsigned int MAX_EXTRA_ITERATIONS = 64;
+
+// Both estimates are lower bounds in exact arithmetic, this leaves room for the rounding and the finite escape radius
+constexpr double SAFETY_FACTOR = 0.9;
+
+// A point of the orbit counts as back at the start within this distance (relative), Newton's method does the rest
+constexpr double PERIOD_TOLERANCE_SQUARED = 1e-12;
+constexpr int NEWTON_STEPS = 16;
+
+/**
+ * Continues the orbit of an escaped point to a large radius and evaluates the exterior estimate
+ *
+ * @param n Iteration of `z`, where `z` of iteration 1 is `c`
+ */
+double exteriorDistance(Complex z, Complex derivative, std::uint32_t n, const Complex& c) {
+    for (unsigned int i = 0; i < MAX_EXTRA_ITERATIONS && z.norm() < ESTIMATE_RADIUS_SQUARED; i++, n++) {
+        derivative = z * derivative * 2.0 + Complex{1.0, 0.0};
+        z = z * z + c;
+    }
+
+    // dist(c, M) > sinh(G) / (2 e^G |G'|) with the Green's function G = ln|Z_n| / 2^n, which is
+    // |Z| ln|Z| / (2 |dZ/dc|) times (1 - e^-2G) / 2G, written this way because 2^n overflows
+    double magnitude = z.abs();
+    double logMagnitude = std::log(magnitude);
+    double green = std::ldexp(logMagnitude, -static_cast<int>(n));
+    double factor = green > 0.0 ? -std::expm1(-2.0 * green) / (2.0 * green) : 1.0;
+    double distance = SAFETY_FACTOR * factor * magnitude * logMagnitude / (2.0 * derivative.abs());
+    return std::isfinite(distance) && distance > 0.0 ? distance : 0.0;
+}
+
+/**
+ * Finds the attracting cycle near `z` and evaluates the interior estimate
+ */
+double interiorDistance(const Complex& z, const Complex& c, unsigned int maxPeriod) {
+    // The period is the first return close to the start
+    unsigned int period = 0;
+    Complex w = z;
+    for (unsigned int p = 1; p <= maxPeriod; p++) {
+        w = w * w + c;
+        if ((w - z).norm() < PERIOD_TOLERANCE_SQUARED * (1.0 + z.norm())) {
+            period = p;
+            break;
+        }
+    }
+    if (period == 0)
+        return 0.0;
+
+    // Newton's method on f^p(w) - w = 0 moves the start onto the cycle
+    w = z;
+    for (int step = 0; step < NEWTON_STEPS; step++) {
+        Complex point = w;
+        Complex derivative{1.0, 0.0};
+        for (unsigned int i = 0; i < period; i++) {
+            derivative = point * derivative * 2.0;
+            point = point * point + c;
+        }
+        Complex correction = (point - w) / (derivative - Complex{1.0, 0.0});
+        w = w - correction;
+        if (correction.norm() < 1e-30 * (1.0 + w.norm()))
+            break;
+    }
+
+    // Derivatives of f^p at the cycle point: by z, by c, and the second ones by z z and by c z
+    Complex point = w;
+    Complex byZ{1.0, 0.0};
+    Complex byC{0.0, 0.0};
+    Complex byZZ{0.0, 0.0};
+    Complex byCZ{0.0, 0.0};
+    for (unsigned int i = 0; i < period; i++) {
+        byCZ = (byZ * byC + point * byCZ) * 2.0;
+        byZZ = (byZ * byZ + point * byZZ) * 2.0;
+        byC = point * byC * 2.0 + Complex{1.0, 0.0};
+        byZ = point * byZ * 2.0;
+        point = point * point + c;
+    }
+    if ((point - w).norm() > 1e-20 * (1.0 + w.norm()) || byZ.norm() >= 1.0)
+        return 0.0;
+
+    // b / 4 <= dist(c, boundary of M) for b = (1 - |dz|^2) / |dcdz + dzdz dc / (1 - dz)|
+    Complex denominator = byCZ + byZZ * byC / (Complex{1.0, 0.0} - byZ);
+    double distance = SAFETY_FACTOR * 0.25 * (1.0 - byZ.norm()) / denominator.abs();
+    return std::isfinite(distance) && distance > 0.0 ? distance : 0.0;
+}
+
+} // namespace
+
+std::uint32_t calcMandelDistance(double startReal, double startImag, unsigned int maxIterations, double& distance) {
+    // The cycles of the cardioid and the bulb have closed forms: the fixed point (1 - sqrt(1 - 4c)) / 2, attracting
+    // where |2w| < 1, or else a root of w^2 + w + c + 1 = 0, the period 2 points
+    Complex c{startReal, startImag};
+    if (isInMainCardioidOrBulb(startReal, startImag)) {
+        Complex fixedPoint = (Complex{1.0, 0.0} - (Complex{1.0, 0.0} - c * 4.0).sqrt()) * 0.5;
+        Complex cyclePoint = fixedPoint.norm() < 0.25 ? fixedPoint : ((Complex{-3.0, 0.0} - c * 4.0).sqrt() - Complex{1.0, 0.0}) * 0.5;
+        distance = interiorDistance(cyclePoint, c, 2);
+        return 0;
+    }
+
+    double real = startReal;
+    double imag = startImag;
+    Complex derivative{1.0, 0.0};
+    double checkReal = real;
+    double checkImag = imag;
+    std::uint32_t nextCheck = 1;
+
+    // Same operations in the same order as `calcMandel`, so the count matches
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        if ((real * real) + (imag * imag) > 4.0) {
+            distance = exteriorDistance({real, imag}, derivative, n, c);
+            return n;
+        }
+        derivative = Complex{real, imag} * derivative * 2.0 + Complex{1.0, 0.0};
+        double realTemp = real;
+
+        real = (real * real) - (imag * imag) + startReal;
+        imag = 2.0 * realTemp * imag + startImag;
+
+        // An orbit that repeats exactly sits on its cycle, slower ones are near the boundary where the disk would be small
+        if (real == checkReal && imag == checkImag) {
+            distance = interiorDistance({real, imag}, c, n);
+            return 0;
+        }
+        if (n == nextCheck) {
+            checkReal = real;
+            checkImag = imag;
+            nextCheck *= 2;
+        }
+    }
+    distance = 0.0;
+    return 0;
+}
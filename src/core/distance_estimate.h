@@ -0,0 +1,21 @@
+#pragma once
+#ifndef MANDELBROT_DISTANCEESTIMATE_INCLUDED
+#define MANDELBROT_DISTANCEESTIMATE_INCLUDED
+
+#include <cstdint>
+
+/**
+ * `calcMandel` that also finds a disk around the point which lies entirely on its side of the boundary of the set
+ *
+ * Escaped points get the exterior estimate from the derivative `dZ/dc`: by Koebe's 1/4 theorem no point of the set is
+ * closer than about a quarter of `2 |Z| ln|Z| / |dZ/dc|`. Points in the main cardioid or the period-2 bulb, and points
+ * whose orbit repeats exactly, get the interior estimate over one period of their attracting cycle (refined with Newton's
+ * method), a disk inside the set. Orbits that neither escape nor repeat get no disk.
+ *
+ * The iteration count is the same as `calcMandel`'s, only the disk is extra.
+ *
+ * @param distance Receives the radius of the disk, 0 if there is none (the cycle was not found or not attracting)
+ */
+std::uint32_t calcMandelDistance(double startReal, double startImag, unsigned int maxIterations, double& distance);
+
+#endif
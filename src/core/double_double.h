@@ -0,0 +1,99 @@
+#pragma once
+#ifndef MANDELBROT_DOUBLEDOUBLE_INCLUDED
+#define MANDELBROT_DOUBLEDOUBLE_INCLUDED
+
+#include <cmath>
+
+#include "big_fixed.h"
+
+/**
+ * Unevaluated sum of two `double` ("double-double"), about 106 bits of mantissa
+ *
+ * `high` is the value rounded to `double`, `low` the rounding error, `|low| <= ulp(high) / 2`. The operations
+ * rely on exact IEEE rounding, files that use them are compiled without floating-point contraction
+ * (see `CMakeLists.txt`), which would turn the error terms into 0.
+ */
+struct DoubleDouble {
+    double high = 0.0;
+    double low = 0.0;
+
+    DoubleDouble() = default;
+    DoubleDouble(double value) : high{value} {}
+    DoubleDouble(double valueHigh, double valueLow) : high{valueHigh}, low{valueLow} {}
+
+    static DoubleDouble fromLongDouble(long double value) {
+        double valueHigh = static_cast<double>(value);
+        return {valueHigh, static_cast<double>(value - valueHigh)};
+    }
+
+    /**
+     * @return `value` rounded to about 106 bits
+     */
+    static DoubleDouble fromBigFixed(const BigFixed& value) {
+        double valueHigh = value.toDouble();
+        return {valueHigh, (value - BigFixed{valueHigh, value.getFractionLimbs()}).toDouble()};
+    }
+
+    /**
+     * @return `a + b` exactly, for `|a| >= |b|`
+     */
+    static inline DoubleDouble quickTwoSum(double a, double b) {
+        double sum = a + b;
+        return {sum, b - (sum - a)};
+    }
+
+    /**
+     * @return `a + b` exactly
+     */
+    static inline DoubleDouble twoSum(double a, double b) {
+        double sum = a + b;
+        double bVirtual = sum - a;
+        return {sum, (a - (sum - bVirtual)) + (b - bVirtual)};
+    }
+
+    /**
+     * @return `a * b` exactly, with a fused multiply-add if the target has one, else with Dekker's splitting
+     */
+    static inline DoubleDouble twoProduct(double a, double b) {
+        double product = a * b;
+#if defined(__FMA__)
+        return {product, std::fma(a, b, -product)};
+#else
+        constexpr double SPLITTER = 134217729.0; // 2^27 + 1
+        double aBig = SPLITTER * a;
+        double aHigh = aBig - (aBig - a);
+        double aLow = a - aHigh;
+        double bBig = SPLITTER * b;
+        double bHigh = bBig - (bBig - b);
+        double bLow = b - bHigh;
+        return {product, ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow};
+#endif
+    }
+
+    inline DoubleDouble operator+(const DoubleDouble& other) const {
+        DoubleDouble sum = twoSum(high, other.high);
+        DoubleDouble error = twoSum(low, other.low);
+        sum = quickTwoSum(sum.high, sum.low + error.high);
+        return quickTwoSum(sum.high, sum.low + error.low);
+    }
+
+    inline DoubleDouble operator-() const { return {-high, -low}; }
+    inline DoubleDouble operator-(const DoubleDouble& other) const { return *this + (-other); }
+
+    inline DoubleDouble operator*(const DoubleDouble& other) const {
+        DoubleDouble product = twoProduct(high, other.high);
+        return quickTwoSum(product.high, product.low + (high * other.low + low * other.high));
+    }
+
+    inline DoubleDouble square() const {
+        DoubleDouble product = twoProduct(high, high);
+        return quickTwoSum(product.high, product.low + 2.0 * high * low);
+    }
+
+    /**
+     * @return The value times 2, exact
+     */
+    inline DoubleDouble doubled() const { return {2.0 * high, 2.0 * low}; }
+};
+
+#endif
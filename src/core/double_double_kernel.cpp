@@ -0,0 +1,37 @@
+#include "double_double_kernel.h"
+
+std::uint32_t calcMandelDoubleDouble(const DoubleDouble& startReal, const DoubleDouble& startImag, unsigned int maxIterations) {
+    DoubleDouble real = startReal;
+    DoubleDouble imag = startImag;
+
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        // The low parts do not change whether the point is outside the escape radius
+        if ((real.high * real.high) + (imag.high * imag.high) > 4.0)
+            return n;
+        DoubleDouble realTemp = real;
+
+        real = real.square() - imag.square() + startReal;
+        imag = (realTemp * imag).doubled() + startImag;
+    }
+    return 0;
+}
+
+void iterateDoubleDouble(const double* startRealHigh, const double* startRealLow, const double* startImagHigh, const double* startImagLow,
+    std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        result[i] = calcMandelDoubleDouble({startRealHigh[i], startRealLow[i]}, {startImagHigh[i], startImagLow[i]}, maxIterations);
+        std::uint64_t iterations = result[i] == 0 ? maxIterations : result[i];
+        statistics.iterations += iterations;
+        statistics.laneSlots += iterations;
+    }
+}
+
+DoubleDoubleKernel selectDoubleDoubleKernel(KernelIsa isa) {
+#if defined(MANDELBROT_X86_KERNELS)
+    if ((isa == KernelIsa::Avx2 || isa == KernelIsa::Avx512) && isIsaSupported(KernelIsa::Avx2))
+        return iterateDoubleDoubleAvx2;
+#endif
+    (void)isa;
+    return iterateDoubleDouble;
+}
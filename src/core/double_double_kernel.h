@@ -0,0 +1,37 @@
+#pragma once
+#ifndef MANDELBROT_DOUBLEDOUBLEKERNEL_INCLUDED
+#define MANDELBROT_DOUBLEDOUBLEKERNEL_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iteration_kernel.h"
+#include "double_double.h"
+
+/**
+ * `calcMandel` in double-double, for views between the limit of `double` and the depths that need perturbation
+ *
+ * @return Returns the iteration in which the point escaped (starting at 1), or 0 if it did not escape within `maxIterations`
+ */
+std::uint32_t calcMandelDoubleDouble(const DoubleDouble& startReal, const DoubleDouble& startImag, unsigned int maxIterations);
+
+/**
+ * Runs `calcMandelDoubleDouble` for `count` points, each given as the high and low parts of its coordinates
+ */
+void iterateDoubleDouble(const double* startRealHigh, const double* startRealLow, const double* startImagHigh, const double* startImagLow,
+    std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+using DoubleDoubleKernel = void (*)(const double* startRealHigh, const double* startRealLow, const double* startImagHigh, const double* startImagLow,
+    std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+#if defined(MANDELBROT_X86_KERNELS)
+void iterateDoubleDoubleAvx2(const double* startRealHigh, const double* startRealLow, const double* startImagHigh, const double* startImagLow,
+    std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+#endif
+
+/**
+ * @return The double-double kernel for `isa`, the AVX2 one also serves AVX-512, falls back to `iterateDoubleDouble`
+ */
+DoubleDoubleKernel selectDoubleDoubleKernel(KernelIsa isa);
+
+#endif
@@ -0,0 +1,112 @@
+#include "double_double_kernel.h"
+
+#include <immintrin.h>
+
+// This file is compiled with -mavx2 and without FMA contraction. Every lane does the operations of `DoubleDouble`
+// in the same order, the products are split like Dekker's, which is exact just like the scalar kernel's products,
+// so the results are bit-identical.
+
+namespace {
+
+struct Vector2 {
+    __m256d high;
+    __m256d low;
+};
+
+inline Vector2 quickTwoSum(__m256d a, __m256d b) {
+    __m256d sum = _mm256_add_pd(a, b);
+    return {sum, _mm256_sub_pd(b, _mm256_sub_pd(sum, a))};
+}
+
+inline Vector2 twoSum(__m256d a, __m256d b) {
+    __m256d sum = _mm256_add_pd(a, b);
+    __m256d bVirtual = _mm256_sub_pd(sum, a);
+    return {sum, _mm256_add_pd(_mm256_sub_pd(a, _mm256_sub_pd(sum, bVirtual)), _mm256_sub_pd(b, bVirtual))};
+}
+
+inline Vector2 twoProduct(__m256d a, __m256d b) {
+    const __m256d splitter = _mm256_set1_pd(134217729.0); // 2^27 + 1
+    __m256d product = _mm256_mul_pd(a, b);
+    __m256d aBig = _mm256_mul_pd(splitter, a);
+    __m256d aHigh = _mm256_sub_pd(aBig, _mm256_sub_pd(aBig, a));
+    __m256d aLow = _mm256_sub_pd(a, aHigh);
+    __m256d bBig = _mm256_mul_pd(splitter, b);
+    __m256d bHigh = _mm256_sub_pd(bBig, _mm256_sub_pd(bBig, b));
+    __m256d bLow = _mm256_sub_pd(b, bHigh);
+    __m256d error = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(aHigh, bHigh), product), _mm256_mul_pd(aHigh, bLow)),
+        _mm256_mul_pd(aLow, bHigh));
+    return {product, _mm256_add_pd(error, _mm256_mul_pd(aLow, bLow))};
+}
+
+inline Vector2 add(const Vector2& a, const Vector2& b) {
+    Vector2 sum = twoSum(a.high, b.high);
+    Vector2 error = twoSum(a.low, b.low);
+    sum = quickTwoSum(sum.high, _mm256_add_pd(sum.low, error.high));
+    return quickTwoSum(sum.high, _mm256_add_pd(sum.low, error.low));
+}
+
+inline Vector2 negate(const Vector2& a) {
+    const __m256d signBit = _mm256_set1_pd(-0.0);
+    return {_mm256_xor_pd(a.high, signBit), _mm256_xor_pd(a.low, signBit)};
+}
+
+inline Vector2 multiply(const Vector2& a, const Vector2& b) {
+    Vector2 product = twoProduct(a.high, b.high);
+    __m256d cross = _mm256_add_pd(_mm256_mul_pd(a.high, b.low), _mm256_mul_pd(a.low, b.high));
+    return quickTwoSum(product.high, _mm256_add_pd(product.low, cross));
+}
+
+inline Vector2 square(const Vector2& a) {
+    Vector2 product = twoProduct(a.high, a.high);
+    __m256d cross = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), a.high), a.low);
+    return quickTwoSum(product.high, _mm256_add_pd(product.low, cross));
+}
+
+inline Vector2 doubled(const Vector2& a) {
+    return {_mm256_add_pd(a.high, a.high), _mm256_add_pd(a.low, a.low)};
+}
+
+} // namespace
+
+void iterateDoubleDoubleAvx2(const double* startRealHigh, const double* startRealLow, const double* startImagHigh, const double* startImagLow,
+    std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    constexpr std::size_t LANES = 4;
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        const Vector2 cReal{_mm256_loadu_pd(startRealHigh + i), _mm256_loadu_pd(startRealLow + i)};
+        const Vector2 cImag{_mm256_loadu_pd(startImagHigh + i), _mm256_loadu_pd(startImagLow + i)};
+        Vector2 real = cReal;
+        Vector2 imag = cImag;
+        __m256d active = allLanes;
+        __m256d escapedAt = _mm256_setzero_pd();
+        __m256d n = one;
+
+        std::uint64_t steps = 0;
+        for (unsigned int iteration = 1; iteration < maxIterations + 1; iteration++) {
+            steps++;
+            __m256d magnitude = _mm256_add_pd(_mm256_mul_pd(real.high, real.high), _mm256_mul_pd(imag.high, imag.high));
+            __m256d escaped = _mm256_and_pd(_mm256_cmp_pd(magnitude, four, _CMP_GT_OQ), active);
+            escapedAt = _mm256_blendv_pd(escapedAt, n, escaped);
+            active = _mm256_andnot_pd(escaped, active);
+            if (_mm256_movemask_pd(active) == 0)
+                break;
+
+            Vector2 realTemp = real;
+            real = add(add(square(real), negate(square(imag))), cReal);
+            imag = add(doubled(multiply(realTemp, imag)), cImag);
+            n = _mm256_add_pd(n, one);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm256_cvttpd_epi32(escapedAt));
+        for (std::size_t lane = 0; lane < LANES; lane++)
+            statistics.iterations += result[i + lane] == 0 ? maxIterations : result[i + lane];
+        statistics.laneSlots += steps * LANES;
+    }
+
+    iterateDoubleDouble(startRealHigh + i, startRealLow + i, startImagHigh + i, startImagLow + i, count - i, maxIterations, result + i, statistics);
+}
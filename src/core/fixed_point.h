@@ -0,0 +1,130 @@
+#pragma once
+#ifndef MANDELBROT_FIXEDPOINT_INCLUDED
+#define MANDELBROT_FIXEDPOINT_INCLUDED
+
+#include <cstdint>
+
+#include "big_fixed.h"
+
+/**
+ * Two's complement fixed-point number with 7 integer bits, a sign bit and `FRACTION_BITS` fraction bits in 128 bits
+ *
+ * The 7 integer bits hold every value the escape-time iteration produces: points with `|c| > 2` escape before the
+ * first step, so `|Z| <= 6` and the sum of the squares stays below 128. The high word alone is the same format with
+ * 56 fraction bits, which is what the 64 bit kernel iterates in.
+ */
+struct Fixed128 {
+    static constexpr int FRACTION_BITS = 120;
+    static constexpr int HIGH_FRACTION_BITS = FRACTION_BITS - 64;
+
+    std::uint64_t high = 0; // Holds the sign, cast it to `std::int64_t` to read the value
+    std::uint64_t low = 0;
+
+    /**
+     * @return `value` truncated toward zero to 120 fraction bits, saturated to +-4, which still escapes in the first iteration
+     */
+    static Fixed128 fromBigFixed(const BigFixed& value) {
+        constexpr long double LIMIT = 4.0L;
+        BigFixed magnitude = value.isNegative() ? -value : value;
+        if (magnitude.toLongDouble() >= LIMIT)
+            magnitude = BigFixed{LIMIT, 0};
+
+        // Peel off 32 bits at a time, each chunk is an integer below 2^32 and exact in every floating-point type
+        std::uint32_t chunks[4];
+        BigFixed rest = magnitude.scaledByPowerOfTwo(FRACTION_BITS - 96);
+        for (int i = 0; i < 4; i++) {
+            BigFixed integer = rest.withPrecision(0);
+            chunks[i] = static_cast<std::uint32_t>(integer.toLongDouble());
+            rest = (rest - integer.withPrecision(rest.getFractionLimbs())).scaledByPowerOfTwo(32);
+        }
+        Fixed128 result{(std::uint64_t{chunks[0]} << 32) | chunks[1], (std::uint64_t{chunks[2]} << 32) | chunks[3]};
+        return value.isNegative() ? -result : result;
+    }
+
+    /**
+     * @return 2^`exponent` for `-120 <= exponent <= 6`
+     */
+    static Fixed128 powerOfTwo(int exponent) {
+        int bit = FRACTION_BITS + exponent;
+        return bit >= 64 ? Fixed128{std::uint64_t{1} << (bit - 64), 0} : Fixed128{0, std::uint64_t{1} << bit};
+    }
+
+    inline bool isNegative() const { return static_cast<std::int64_t>(high) < 0; }
+
+    inline Fixed128 operator+(const Fixed128& other) const {
+        std::uint64_t sumLow = low + other.low;
+        return {high + other.high + (sumLow < low ? 1 : 0), sumLow};
+    }
+
+    inline Fixed128 operator-() const {
+        return {~high + (low == 0 ? 1 : 0), ~low + 1};
+    }
+
+    inline Fixed128 operator-(const Fixed128& other) const { return *this + (-other); }
+
+    /**
+     * @return The product truncated toward zero to 120 fraction bits, as long as it stays within the integer bits
+     */
+    inline Fixed128 operator*(const Fixed128& other) const {
+        bool negative = isNegative() != other.isNegative();
+        Fixed128 a = isNegative() ? -*this : *this;
+        Fixed128 b = other.isNegative() ? -other : other;
+
+        // 256 bit product of the magnitudes from four 64 x 64 bit products, only bits 120 to 247 are kept
+        std::uint64_t lowLowHigh;
+        multiplyWide(a.low, b.low, lowLowHigh);
+        std::uint64_t crossHigh1;
+        std::uint64_t cross1 = multiplyWide(a.low, b.high, crossHigh1);
+        std::uint64_t crossHigh2;
+        std::uint64_t cross2 = multiplyWide(a.high, b.low, crossHigh2);
+        std::uint64_t highHigh;
+        std::uint64_t highLow = multiplyWide(a.high, b.high, highHigh);
+
+        std::uint64_t word1 = lowLowHigh + cross1;
+        std::uint64_t carry = word1 < cross1 ? 1 : 0;
+        word1 += cross2;
+        carry += word1 < cross2 ? 1 : 0;
+        std::uint64_t word2 = highLow + carry;
+        std::uint64_t word3 = highHigh + (word2 < carry ? 1 : 0);
+        word2 += crossHigh1;
+        word3 += word2 < crossHigh1 ? 1 : 0;
+        word2 += crossHigh2;
+        word3 += word2 < crossHigh2 ? 1 : 0;
+
+        constexpr int SHIFT = FRACTION_BITS - 64;
+        Fixed128 result{(word3 << (64 - SHIFT)) | (word2 >> SHIFT), (word2 << (64 - SHIFT)) | (word1 >> SHIFT)};
+        return negative ? -result : result;
+    }
+
+    inline Fixed128 square() const { return *this * *this; }
+
+    inline bool isGreaterThan(const Fixed128& other) const {
+        if (high != other.high)
+            return static_cast<std::int64_t>(high) > static_cast<std::int64_t>(other.high);
+        return low > other.low;
+    }
+
+    /**
+     * @return `a * b` with 128 bits, the low half is returned and the high half written to `high`
+     */
+    static inline std::uint64_t multiplyWide(std::uint64_t a, std::uint64_t b, std::uint64_t& high) {
+#if defined(__SIZEOF_INT128__)
+        __extension__ using UnsignedInt128 = unsigned __int128; // GCC and Clang only, __extension__ silences -Wpedantic
+        UnsignedInt128 product = static_cast<UnsignedInt128>(a) * b;
+        high = static_cast<std::uint64_t>(product >> 64);
+        return static_cast<std::uint64_t>(product);
+#else
+        std::uint64_t aLow = a & 0xffffffffu;
+        std::uint64_t aHigh = a >> 32;
+        std::uint64_t bLow = b & 0xffffffffu;
+        std::uint64_t bHigh = b >> 32;
+        std::uint64_t lowLow = aLow * bLow;
+        std::uint64_t middle1 = aHigh * bLow + (lowLow >> 32);
+        std::uint64_t middle2 = aLow * bHigh + (middle1 & 0xffffffffu);
+        high = aHigh * bHigh + (middle1 >> 32) + (middle2 >> 32);
+        return (middle2 << 32) | (lowLow & 0xffffffffu);
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include "fixed_point_kernel.h"
+
+namespace {
+
+constexpr int FIXED64_FRACTION_BITS = Fixed128::HIGH_FRACTION_BITS;
+
+/**
+ * @return `a * b` rounded down to 56 fraction bits
+ */
+inline std::int64_t multiplyFixed64(std::int64_t a, std::int64_t b) {
+    std::uint64_t unsignedA = static_cast<std::uint64_t>(a);
+    std::uint64_t unsignedB = static_cast<std::uint64_t>(b);
+    std::uint64_t high;
+    std::uint64_t low = Fixed128::multiplyWide(unsignedA, unsignedB, high);
+    // The unsigned product of two's complement numbers is off by b * 2^64 for negative a and vice versa
+    high -= (a < 0 ? unsignedB : 0) + (b < 0 ? unsignedA : 0);
+    return static_cast<std::int64_t>((high << (64 - FIXED64_FRACTION_BITS)) | (low >> FIXED64_FRACTION_BITS));
+}
+
+template <typename Calc, typename Start>
+void iterateFixed(const Fixed128* startReal, const Fixed128* startImag, std::size_t count, unsigned int maxIterations,
+    std::uint32_t* result, KernelStatistics& statistics, Calc calc, Start start)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        result[i] = calc(start(startReal[i]), start(startImag[i]), maxIterations);
+        std::uint64_t iterations = result[i] == 0 ? maxIterations : result[i];
+        statistics.iterations += iterations;
+        statistics.laneSlots += iterations;
+    }
+}
+
+} // namespace
+
+std::uint32_t calcMandelFixed64(std::int64_t startReal, std::int64_t startImag, unsigned int maxIterations) {
+    constexpr std::int64_t FOUR = std::int64_t{4} << FIXED64_FRACTION_BITS;
+    std::int64_t real = startReal;
+    std::int64_t imag = startImag;
+
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        std::int64_t realSquared = multiplyFixed64(real, real);
+        std::int64_t imagSquared = multiplyFixed64(imag, imag);
+        if (realSquared + imagSquared > FOUR)
+            return n;
+
+        imag = 2 * multiplyFixed64(real, imag) + startImag;
+        real = realSquared - imagSquared + startReal;
+    }
+    return 0;
+}
+
+std::uint32_t calcMandelFixed128(const Fixed128& startReal, const Fixed128& startImag, unsigned int maxIterations) {
+    const Fixed128 four = Fixed128::powerOfTwo(2);
+    Fixed128 real = startReal;
+    Fixed128 imag = startImag;
+
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        Fixed128 realSquared = real.square();
+        Fixed128 imagSquared = imag.square();
+        if ((realSquared + imagSquared).isGreaterThan(four))
+            return n;
+
+        Fixed128 realImag = real * imag;
+        imag = realImag + realImag + startImag;
+        real = realSquared - imagSquared + startReal;
+    }
+    return 0;
+}
+
+void iterateFixed64(const Fixed128* startReal, const Fixed128* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    iterateFixed(startReal, startImag, count, maxIterations, result, statistics, calcMandelFixed64,
+        [](const Fixed128& value) { return static_cast<std::int64_t>(value.high); });
+}
+
+void iterateFixed128(const Fixed128* startReal, const Fixed128* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    iterateFixed(startReal, startImag, count, maxIterations, result, statistics, calcMandelFixed128,
+        [](const Fixed128& value) { return value; });
+}
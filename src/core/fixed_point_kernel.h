@@ -0,0 +1,37 @@
+#pragma once
+#ifndef MANDELBROT_FIXEDPOINTKERNEL_INCLUDED
+#define MANDELBROT_FIXEDPOINTKERNEL_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iteration_kernel.h"
+#include "fixed_point.h"
+
+/**
+ * `calcMandel` in 64 bit fixed point (the high words of the start values, 56 fraction bits)
+ *
+ * @return Returns the iteration in which the point escaped (starting at 1), or 0 if it did not escape within `maxIterations`
+ */
+std::uint32_t calcMandelFixed64(std::int64_t startReal, std::int64_t startImag, unsigned int maxIterations);
+
+/**
+ * `calcMandel` in 128 bit fixed point (120 fraction bits)
+ *
+ * @return Returns the iteration in which the point escaped (starting at 1), or 0 if it did not escape within `maxIterations`
+ */
+std::uint32_t calcMandelFixed128(const Fixed128& startReal, const Fixed128& startImag, unsigned int maxIterations);
+
+/**
+ * Fixed-point kernel, computes the iteration counts of `count` points given in `Fixed128`
+ */
+using FixedPointKernel = void (*)(const Fixed128* startReal, const Fixed128* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+void iterateFixed64(const Fixed128* startReal, const Fixed128* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+void iterateFixed128(const Fixed128* startReal, const Fixed128* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+#endif
@@ -0,0 +1,184 @@
+#pragma once
+#ifndef MANDELBROT_FLOATEXP_INCLUDED
+#define MANDELBROT_FLOATEXP_INCLUDED
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * `double` mantissa with a separate exponent ("floatexp"), for perturbation deltas far below the range of `double`
+ *
+ * The value is `mantissa * 2^exponent`. Normalized numbers have `1 <= |mantissa| < 2`, zero is stored as
+ * `mantissa == 0, exponent == 0`. The operations are branch-light and only touch the exponent bits of the
+ * mantissa, so the compiler can vectorize loops over them.
+ */
+struct FloatExp {
+    double mantissa = 0.0;
+    std::int32_t exponent = 0;
+
+    static constexpr std::uint64_t EXPONENT_MASK = std::uint64_t{0x7ff} << 52;
+    static constexpr std::uint64_t EXPONENT_BIAS = 1023;
+
+    FloatExp() = default;
+    FloatExp(double value) : mantissa{value} { normalizeAny(); }
+    FloatExp(double valueMantissa, std::int32_t valueExponent) : mantissa{valueMantissa}, exponent{valueExponent} { normalizeAny(); }
+
+    static FloatExp fromLongDouble(long double value) {
+        int valueExponent = 0;
+        double valueMantissa = static_cast<double>(std::frexp(value, &valueExponent));
+        return {valueMantissa, valueExponent};
+    }
+
+    /**
+     * @return `2^power` for `-1022 <= power <= 1023`, built directly from the exponent bits
+     */
+    static inline double powerOfTwo(std::int32_t power) {
+        return std::bit_cast<double>(static_cast<std::uint64_t>(power + static_cast<std::int32_t>(EXPONENT_BIAS)) << 52);
+    }
+
+    /**
+     * Brings a mantissa that is a normal `double` back into [1, 2)
+     */
+    inline void normalize() {
+        std::uint64_t bits = std::bit_cast<std::uint64_t>(mantissa);
+        std::int32_t shift = static_cast<std::int32_t>((bits & EXPONENT_MASK) >> 52) - static_cast<std::int32_t>(EXPONENT_BIAS);
+        bool zero = mantissa == 0.0;
+        mantissa = std::bit_cast<double>((bits & ~EXPONENT_MASK) | (EXPONENT_BIAS << 52));
+        exponent = zero ? 0 : exponent + shift;
+        mantissa = zero ? 0.0 : mantissa;
+    }
+
+    /**
+     * `normalize` that also copes with subnormal, infinite and NaN mantissas (slow path for construction)
+     */
+    inline void normalizeAny() {
+        if (mantissa == 0.0 || !std::isfinite(mantissa)) {
+            exponent = mantissa == 0.0 ? 0 : exponent;
+            return;
+        }
+        int shift = 0;
+        mantissa = 2.0 * std::frexp(mantissa, &shift);
+        exponent += shift - 1;
+    }
+
+    /**
+     * @return The value as `double`, 0 if it is below the range of `double`
+     */
+    inline double toDouble() const {
+        if (exponent < -1022)
+            return std::ldexp(mantissa, exponent);
+        if (exponent > 1023)
+            return mantissa * HUGE_VAL;
+        return mantissa * powerOfTwo(exponent);
+    }
+
+    inline long double toLongDouble() const { return std::ldexp(static_cast<long double>(mantissa), exponent); }
+
+    inline bool isZero() const { return mantissa == 0.0; }
+
+    inline FloatExp operator-() const { return raw(-mantissa, exponent); }
+
+    inline FloatExp operator*(const FloatExp& other) const {
+        FloatExp result = raw(mantissa * other.mantissa, exponent + other.exponent);
+        result.normalize();
+        return result;
+    }
+
+    inline FloatExp operator*(double factor) const { return *this * FloatExp{factor}; }
+
+    inline FloatExp operator/(const FloatExp& other) const {
+        FloatExp result = raw(mantissa / other.mantissa, exponent - other.exponent);
+        result.normalize();
+        return result;
+    }
+
+    inline FloatExp operator+(const FloatExp& other) const {
+        if (isZero())
+            return other;
+        if (other.isZero())
+            return *this;
+        // The smaller number is shifted to the exponent of the larger one, beyond 64 bits it does not matter
+        bool thisLarger = exponent >= other.exponent;
+        const FloatExp& large = thisLarger ? *this : other;
+        const FloatExp& small = thisLarger ? other : *this;
+        std::int32_t difference = large.exponent - small.exponent;
+        if (difference > 64)
+            return large;
+        FloatExp result = raw(large.mantissa + small.mantissa * powerOfTwo(-difference), large.exponent);
+        result.normalize();
+        return result;
+    }
+
+    inline FloatExp operator-(const FloatExp& other) const { return *this + (-other); }
+
+    inline FloatExp& operator+=(const FloatExp& other) { return *this = *this + other; }
+    inline FloatExp& operator*=(const FloatExp& other) { return *this = *this * other; }
+
+    /**
+     * @return The value times `2^power`, exact
+     */
+    inline FloatExp scaledByPowerOfTwo(std::int32_t power) const { return isZero() ? *this : raw(mantissa, exponent + power); }
+
+    inline FloatExp abs() const { return raw(std::fabs(mantissa), exponent); }
+
+    /**
+     * @return Whether `|this| < |other|`
+     */
+    inline bool isSmallerThan(const FloatExp& other) const {
+        if (isZero() || other.isZero())
+            return !other.isZero();
+        return exponent != other.exponent ? exponent < other.exponent : std::fabs(mantissa) < std::fabs(other.mantissa);
+    }
+
+protected:
+    static inline FloatExp raw(double valueMantissa, std::int32_t valueExponent) {
+        FloatExp result;
+        result.mantissa = valueMantissa;
+        result.exponent = valueExponent;
+        return result;
+    }
+};
+
+/**
+ * Complex number made of two `FloatExp`
+ */
+struct ComplexExp {
+    FloatExp real;
+    FloatExp imag;
+
+    inline ComplexExp operator+(const ComplexExp& other) const { return {real + other.real, imag + other.imag}; }
+
+    inline ComplexExp operator*(const ComplexExp& other) const {
+        return {real * other.real - imag * other.imag, real * other.imag + imag * other.real};
+    }
+
+    /**
+     * @param other Must not be 0
+     */
+    inline ComplexExp operator/(const ComplexExp& other) const {
+        FloatExp norm = other.real * other.real + other.imag * other.imag;
+        return {(real * other.real + imag * other.imag) / norm, (imag * other.real - real * other.imag) / norm};
+    }
+
+    /**
+     * Product with a complex number given as two `double`
+     */
+    inline ComplexExp multiplied(double otherReal, double otherImag) const {
+        return {real * otherReal - imag * otherImag, real * otherImag + imag * otherReal};
+    }
+
+    /**
+     * @return `|this|`, computed without leaving the `FloatExp` range
+     */
+    inline FloatExp magnitude() const {
+        FloatExp larger = real.abs().isSmallerThan(imag.abs()) ? imag.abs() : real.abs();
+        if (larger.isZero())
+            return larger;
+        double realRatio = (real / larger).toDouble();
+        double imagRatio = (imag / larger).toDouble();
+        return larger * std::sqrt(realRatio * realRatio + imagRatio * imagRatio);
+    }
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "flow_color.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The arithmetic below intentionally stays in `float` and keeps the exact comparisons of the shader,
+// so that the CPU renders produce the same colors as the GPU.
+
+namespace {
+
+struct FloatColor {
+    float r;
+    float g;
+    float b;
+};
+
+FloatColor walkColorWheel(float r, float g, float b, float colorStep) {
+    while (true) {
+        if (r == 1.0f && g < 1.0f && b == 0.0f) {
+            if (g + colorStep > 1.0f) {
+                colorStep -= (1.0f - g);
+                g = 1.0f;
+            }
+            else {
+                g += colorStep;
+                break;
+            }
+        }
+        else if (r > 0.0f && g == 1.0f) {
+            if (r - colorStep < 0.0f) {
+                colorStep -= r;
+                r = 0.0f;
+            }
+            else {
+                r -= colorStep;
+                break;
+            }
+        }
+        else if (g == 1.0f && b < 1.0f) {
+            if (b + colorStep > 1.0f) {
+                colorStep -= (1.0f - b);
+                b = 1.0f;
+            }
+            else {
+                b += colorStep;
+                break;
+            }
+        }
+        else if (g > 0.0f && b == 1.0f) {
+            if (g - colorStep < 0.0f) {
+                colorStep -= g;
+                g = 0.0f;
+            }
+            else {
+                g -= colorStep;
+                break;
+            }
+        }
+        else if (b == 1.0f && r < 1.0f) {
+            if (r + colorStep > 1.0f) {
+                colorStep -= (1.0f - r);
+                r = 1.0f;
+            }
+            else {
+                r += colorStep;
+                break;
+            }
+        }
+        else if (b > 0.0f && r == 1.0f) {
+            if (b - colorStep < 0.0f) {
+                colorStep -= b;
+                b = 0.0f;
+            }
+            else {
+                b -= colorStep;
+                break;
+            }
+        }
+        else {
+            break; // Not reachable from the start colors of the shader, but avoids spinning forever
+        }
+    }
+    return {r, g, b};
+}
+
+std::uint8_t toByte(float value) {
+    return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+}
+
+} // namespace
+
+RgbColor flowColor(std::uint32_t index, FlowColorType type) {
+    switch (type) {
+        case FlowColorType::Rgb: {
+            if (index == 0)
+                return {0, 0, 0};
+
+            const std::uint32_t colorAccuracy = 10;
+            float colorStep = static_cast<float>(index % (colorAccuracy * 6)) / colorAccuracy;
+            FloatColor color = walkColorWheel(0.0f, 1.0f, 0.5333f, colorStep);
+            return {toByte(color.r), toByte(color.g), toByte(color.b)};
+        }
+
+        case FlowColorType::BlackWhite:
+            if (index != 0)
+                return {255, 255, 255};
+            return {0, 0, 0};
+
+        case FlowColorType::Glowing: {
+            float brightness = 1.0f - 1.0f / std::exp(0.05f * static_cast<float>(index));
+
+            const std::uint32_t colorAccuracy = 500;
+            float colorStep = static_cast<float>(index % (colorAccuracy * 6)) / colorAccuracy;
+            FloatColor color = walkColorWheel(0.2f, 0.0f, 1.0f, colorStep);
+            return {toByte(color.r * brightness), toByte(color.g * brightness), toByte(color.b * brightness)};
+        }
+    }
+    return {0, 0, 0};
+}
@@ -0,0 +1,28 @@
+#pragma once
+#ifndef MANDELBROT_FLOWCOLOR_INCLUDED
+#define MANDELBROT_FLOWCOLOR_INCLUDED
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Color schemes of the fragment shader, the values match `FLOW_COLOR_TYPE`
+ */
+enum class FlowColorType {
+    Rgb = 0,
+    BlackWhite = 1,
+    Glowing = 2,
+};
+
+using RgbColor = std::array<std::uint8_t, 3>;
+
+/**
+ * CPU port of `flowColor` from `res/fragment_shader.glsl`
+ *
+ * @param index Iteration count as returned by `calcMandel`, 0 means the point did not escape
+ * @param type The color scheme to use
+ * @return The color converted to 8 bits per channel
+ */
+RgbColor flowColor(std::uint32_t index, FlowColorType type);
+
+#endif
@@ -0,0 +1,12 @@
+#include "frame_buffer.h"
+
+RgbImage colorize(const IterationBuffer& buffer, FlowColorType type) {
+    RgbImage image{buffer.width, buffer.height};
+    for (std::size_t i = 0; i < buffer.iterations.size(); i++) {
+        RgbColor color = flowColor(buffer.iterations[i], type);
+        image.pixels[3 * i + 0] = color[0];
+        image.pixels[3 * i + 1] = color[1];
+        image.pixels[3 * i + 2] = color[2];
+    }
+    return image;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#ifndef MANDELBROT_FRAMEBUFFER_INCLUDED
+#define MANDELBROT_FRAMEBUFFER_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "flow_color.h"
+
+/**
+ * Iteration counts of a whole frame, row-major with the top row first
+ * A value of 0 means the pixel did not escape (same convention as `calcMandel`)
+ */
+struct IterationBuffer {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint32_t> iterations;
+
+    IterationBuffer() = default;
+    IterationBuffer(int bufferWidth, int bufferHeight)
+        : width{bufferWidth}, height{bufferHeight}, iterations(static_cast<std::size_t>(bufferWidth) * static_cast<std::size_t>(bufferHeight), 0) {}
+
+    inline std::size_t indexOf(int x, int y) const { return static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x); }
+    inline std::uint32_t& at(int x, int y) { return iterations[indexOf(x, y)]; }
+    inline std::uint32_t at(int x, int y) const { return iterations[indexOf(x, y)]; }
+};
+
+/**
+ * 8 bit RGB image, row-major with the top row first
+ */
+struct RgbImage {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> pixels; // 3 bytes per pixel
+
+    RgbImage() = default;
+    RgbImage(int imageWidth, int imageHeight)
+        : width{imageWidth}, height{imageHeight}, pixels(static_cast<std::size_t>(imageWidth) * static_cast<std::size_t>(imageHeight) * 3, 0) {}
+};
+
+/**
+ * Applies `flowColor` to every pixel of `buffer`
+ */
+RgbImage colorize(const IterationBuffer& buffer, FlowColorType type);
+
+#endif
@@ -0,0 +1,122 @@
+#include "image_writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size, std::uint32_t crc = 0) {
+    static const auto table = [] {
+        std::array<std::uint32_t, 256> values{};
+        for (std::uint32_t n = 0; n < 256; n++) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            values[n] = c;
+        }
+        return values;
+    }();
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+void appendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    out.push_back(static_cast<std::uint8_t>(value >> 24));
+    out.push_back(static_cast<std::uint8_t>(value >> 16));
+    out.push_back(static_cast<std::uint8_t>(value >> 8));
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void writeChunk(std::ofstream& stream, const char* type, const std::vector<std::uint8_t>& data) {
+    std::vector<std::uint8_t> chunk;
+    chunk.reserve(data.size() + 12);
+    appendBigEndian(chunk, static_cast<std::uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    appendBigEndian(chunk, crc32(chunk.data() + 4, data.size() + 4));
+    stream.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+}
+
+/**
+ * Wraps `raw` into a zlib stream made of uncompressed ("stored") deflate blocks
+ */
+std::vector<std::uint8_t> zlibStore(const std::vector<std::uint8_t>& raw) {
+    constexpr std::size_t MAX_BLOCK_SIZE = 65535;
+    std::vector<std::uint8_t> out{0x78, 0x01};
+    out.reserve(raw.size() + raw.size() / MAX_BLOCK_SIZE * 5 + 16);
+
+    std::size_t offset = 0;
+    do {
+        std::size_t blockSize = std::min(MAX_BLOCK_SIZE, raw.size() - offset);
+        bool last = offset + blockSize == raw.size();
+        out.push_back(last ? 1 : 0);
+        out.push_back(static_cast<std::uint8_t>(blockSize));
+        out.push_back(static_cast<std::uint8_t>(blockSize >> 8));
+        out.push_back(static_cast<std::uint8_t>(~blockSize));
+        out.push_back(static_cast<std::uint8_t>(~blockSize >> 8));
+        out.insert(out.end(), raw.begin() + static_cast<std::ptrdiff_t>(offset), raw.begin() + static_cast<std::ptrdiff_t>(offset + blockSize));
+        offset += blockSize;
+    }
+    while (offset < raw.size());
+
+    std::uint32_t a = 1, b = 0; // Adler-32
+    for (std::uint8_t value : raw) {
+        a = (a + value) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(out, (b << 16) | a);
+    return out;
+}
+
+} // namespace
+
+bool writePpm(const std::string& path, const RgbImage& image) {
+    std::ofstream stream{path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc};
+    if (!stream)
+        return false;
+
+    stream << "P6\n" << image.width << " " << image.height << "\n255\n";
+    stream.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+    return static_cast<bool>(stream);
+}
+
+bool writePng(const std::string& path, const RgbImage& image) {
+    std::ofstream stream{path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc};
+    if (!stream)
+        return false;
+
+    const std::uint8_t signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    stream.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<std::uint8_t> header;
+    appendBigEndian(header, static_cast<std::uint32_t>(image.width));
+    appendBigEndian(header, static_cast<std::uint32_t>(image.height));
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8 bit, truecolor, deflate, no filter method, no interlace
+    writeChunk(stream, "IHDR", header);
+
+    // Every scanline is prefixed with filter type 0 (none)
+    std::size_t rowSize = static_cast<std::size_t>(image.width) * 3;
+    std::vector<std::uint8_t> raw;
+    raw.reserve((rowSize + 1) * static_cast<std::size_t>(image.height));
+    for (int y = 0; y < image.height; y++) {
+        raw.push_back(0);
+        auto rowStart = image.pixels.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(y) * rowSize);
+        raw.insert(raw.end(), rowStart, rowStart + static_cast<std::ptrdiff_t>(rowSize));
+    }
+    writeChunk(stream, "IDAT", zlibStore(raw));
+    writeChunk(stream, "IEND", {});
+    return static_cast<bool>(stream);
+}
+
+bool writeImage(const std::string& path, const RgbImage& image) {
+    const std::string extension = ".png";
+    if (path.size() >= extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0)
+        return writePng(path, image);
+    return writePpm(path, image);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef MANDELBROT_IMAGEWRITER_INCLUDED
+#define MANDELBROT_IMAGEWRITER_INCLUDED
+
+#include <string>
+
+#include "frame_buffer.h"
+
+/**
+ * Writes a binary PPM (P6) file
+ *
+ * @return Returns `true` if the file was written successfully
+ */
+bool writePpm(const std::string& path, const RgbImage& image);
+
+/**
+ * Writes a PNG file
+ * The image data is stored without compression, so no zlib is needed
+ *
+ * @return Returns `true` if the file was written successfully
+ */
+bool writePng(const std::string& path, const RgbImage& image);
+
+/**
+ * Picks `writePng` or `writePpm` depending on the file extension (".png" or anything else)
+ */
+bool writeImage(const std::string& path, const RgbImage& image);
+
+#endif
@@ -0,0 +1,107 @@
+#include "iteration_kernel.h"
+
+namespace {
+
+/**
+ * The loop of `calcMandel` without the interior test
+ *
+ * @param executed Receives the number of iterations that ran
+ * @param periodic Receives whether the loop stopped because the orbit repeated
+ */
+std::uint32_t iterateOrbit(double startReal, double startImag, unsigned int maxIterations, std::uint32_t& executed, bool& periodic) {
+    double real = startReal;
+    double imag = startImag;
+    double checkReal = real;
+    double checkImag = imag;
+    std::uint32_t nextCheck = 1;
+    periodic = false;
+
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        if ((real * real) + (imag * imag) > 4.0) {
+            executed = n;
+            return n;
+        }
+        double realTemp = real;
+
+        real = (real * real) - (imag * imag) + startReal;
+        imag = 2.0 * realTemp * imag + startImag;
+
+        if (real == checkReal && imag == checkImag) {
+            executed = n;
+            periodic = true;
+            return 0;
+        }
+        if (n == nextCheck) {
+            checkReal = real;
+            checkImag = imag;
+            nextCheck *= 2;
+        }
+    }
+    executed = maxIterations;
+    return 0;
+}
+
+} // namespace
+
+bool isInMainCardioidOrBulb(double real, double imag) {
+    double imagSquared = imag * imag;
+    double shifted = real - 0.25;
+    double q = shifted * shifted + imagSquared;
+    if (q * (q + shifted) <= 0.25 * imagSquared)
+        return true;
+    double bulb = real + 1.0;
+    return bulb * bulb + imagSquared <= 0.0625;
+}
+
+std::uint32_t calcMandel(double startReal, double startImag, unsigned int maxIterations) {
+    if (isInMainCardioidOrBulb(startReal, startImag))
+        return 0;
+    std::uint32_t executed;
+    bool periodic;
+    return iterateOrbit(startReal, startImag, maxIterations, executed, periodic);
+}
+
+void iterateScalar(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    for (std::size_t i = 0; i < count; i++) {
+        if (isInMainCardioidOrBulb(startReal[i], startImag[i])) {
+            result[i] = 0;
+            statistics.bulbPixels++;
+            continue;
+        }
+        std::uint32_t executed;
+        bool periodic;
+        result[i] = iterateOrbit(startReal[i], startImag[i], maxIterations, executed, periodic);
+        statistics.iterations += executed;
+        statistics.laneSlots += executed;
+        statistics.periodicPixels += periodic ? 1 : 0;
+    }
+}
+
+IterationKernel selectKernel(KernelIsa isa, KernelMode mode) {
+    if (!isIsaSupported(isa))
+        return iterateScalar;
+
+    bool streaming = mode == KernelMode::Streaming;
+    switch (isa) {
+#if defined(MANDELBROT_X86_KERNELS)
+        case KernelIsa::Avx2:
+            return streaming ? iterateStreamAvx2 : iterateAvx2;
+        case KernelIsa::Avx512:
+            return streaming ? iterateStreamAvx512 : iterateAvx512;
+#endif
+        default:
+            return iterateScalar;
+    }
+}
+
+const char* kernelModeName(KernelMode mode) {
+    switch (mode) {
+        case KernelMode::Batched:
+            return "batched";
+        case KernelMode::Streaming:
+            return "streaming";
+    }
+    return "unknown";
+}
@@ -0,0 +1,98 @@
+#pragma once
+#ifndef MANDELBROT_ITERATIONKERNEL_INCLUDED
+#define MANDELBROT_ITERATIONKERNEL_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu_features.h"
+
+/**
+ * Counters every kernel fills in while iterating
+ */
+struct KernelStatistics {
+    std::uint64_t iterations = 0; // Escape-time iterations summed over all pixels (= useful work)
+    std::uint64_t laneSlots = 0; // Vector steps times vector width, including lanes that had nothing to do
+    std::uint64_t bulbPixels = 0; // Pixels in the main cardioid or the period-2 bulb, settled without iterating
+    std::uint64_t periodicPixels = 0; // Pixels whose orbit came back to an earlier value, stopped before the limit
+    std::uint64_t filledPixels = 0; // Pixels the renderer filled from a uniform rectangle border, never handed to a kernel
+    std::uint64_t provenPixels = 0; // Pixels the renderer filled because ball arithmetic proved their whole rectangle uniform
+    std::uint64_t distancePixels = 0; // Pixels the renderer filled because they lie in the distance estimate disk of another pixel
+    std::uint64_t guessedPixels = 0; // Pixels of progressive frames that took the count their coarser neighbours agreed on
+
+    /**
+     * @return The fraction of SIMD lanes that did useful work (1 for the scalar kernel)
+     */
+    inline double laneUtilization() const { return laneSlots > 0 ? static_cast<double>(iterations) / static_cast<double>(laneSlots) : 1.0; }
+};
+
+/**
+ * How the SIMD kernels assign pixels to lanes
+ */
+enum class KernelMode {
+    Batched = 0,   // A vector of neighbouring pixels runs until its slowest lane is done
+    Streaming = 1, // A lane pulls the next pixel from the queue as soon as its pixel is done
+};
+
+/**
+ * Escape-time kernel, computes `calcMandel` for `count` points
+ *
+ * All kernels return exactly the same iteration counts, only their speed differs.
+ *
+ * @param startReal Real parts of the points
+ * @param startImag Imaginary parts of the points
+ * @param count Number of points
+ * @param maxIterations Iteration limit
+ * @param result Receives the iteration counts (0 for points that did not escape)
+ * @param statistics Counters get added to this
+ */
+using IterationKernel = void (*)(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+/**
+ * Closed-form test for the two largest interior components, the main cardioid and the period-2 bulb
+ *
+ * Lives in `iteration_kernel.cpp` (not inline) so the SIMD kernels, whose files are compiled for wider instruction
+ * sets, call the very same code and every kernel settles the same pixels.
+ *
+ * @return Whether the point lies in either, it never escapes then
+ */
+bool isInMainCardioidOrBulb(double real, double imag);
+
+/**
+ * CPU port of `calcMandel` from `res/fragment_shader.glsl`
+ *
+ * Points in the main cardioid or the period-2 bulb return 0 right away. The orbit is also compared to a value saved
+ * at iterations 1, 2, 4, 8, ... (Brent's cycle detection): once it comes back to it exactly, the iteration would repeat
+ * forever and 0 is returned. Both only ever return what the full loop would, `maxIterations` steps later.
+ *
+ * @return Returns the iteration in which the point escaped (starting at 1), or 0 if it did not escape within `maxIterations`
+ */
+std::uint32_t calcMandel(double startReal, double startImag, unsigned int maxIterations);
+
+void iterateScalar(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+#if defined(MANDELBROT_X86_KERNELS)
+void iterateAvx2(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+void iterateAvx512(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+// Streaming variants, the `count` points form the queue the lanes refill from
+void iterateStreamAvx2(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+void iterateStreamAvx512(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+#endif
+
+/**
+ * @return The kernel for `isa` and `mode`, falls back to `iterateScalar` if `isa` is not supported on this machine
+ */
+IterationKernel selectKernel(KernelIsa isa, KernelMode mode = KernelMode::Batched);
+
+const char* kernelModeName(KernelMode mode);
+
+#endif
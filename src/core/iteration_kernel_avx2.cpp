@@ -0,0 +1,205 @@
+#include "iteration_kernel.h"
+
+#include <immintrin.h>
+#include <limits>
+
+// This file is compiled with -mavx2 and without FMA contraction, so every lane does
+// exactly the same roundings as `calcMandel` and the results are bit-identical. The interior
+// test and the cycle detection of `calcMandel` are done per lane as well.
+
+void iterateAvx2(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    constexpr std::size_t LANES = 4;
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d allLanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        const __m256d cReal = _mm256_loadu_pd(startReal + i);
+        const __m256d cImag = _mm256_loadu_pd(startImag + i);
+        __m256d real = cReal;
+        __m256d imag = cImag;
+        __m256d checkReal = real;
+        __m256d checkImag = imag;
+        __m256d escapedAt = _mm256_setzero_pd();
+        __m256d stoppedAt = _mm256_setzero_pd(); // Iteration in which a lane was found periodic
+        __m256d n = one;
+
+        // Lanes in the main cardioid or the period-2 bulb never become active
+        alignas(32) std::int64_t laneActive[LANES];
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            bool interior = isInMainCardioidOrBulb(startReal[i + lane], startImag[i + lane]);
+            laneActive[lane] = interior ? 0 : -1;
+            statistics.bulbPixels += interior ? 1 : 0;
+        }
+        __m256d active = _mm256_castsi256_pd(_mm256_load_si256(reinterpret_cast<const __m256i*>(laneActive)));
+        __m256d interior = _mm256_xor_pd(active, allLanes);
+
+        std::uint64_t steps = 0;
+        unsigned int nextCheck = 1;
+        unsigned int iterationLimit = _mm256_movemask_pd(active) == 0 ? 0 : maxIterations;
+        for (unsigned int iteration = 1; iteration < iterationLimit + 1; iteration++) {
+            steps++;
+            __m256d realSquared = _mm256_mul_pd(real, real);
+            __m256d imagSquared = _mm256_mul_pd(imag, imag);
+            __m256d escaped = _mm256_and_pd(_mm256_cmp_pd(_mm256_add_pd(realSquared, imagSquared), four, _CMP_GT_OQ), active);
+            escapedAt = _mm256_blendv_pd(escapedAt, n, escaped);
+            active = _mm256_andnot_pd(escaped, active);
+            if (_mm256_movemask_pd(active) == 0)
+                break;
+
+            __m256d realImag = _mm256_mul_pd(real, imag);
+            imag = _mm256_add_pd(_mm256_add_pd(realImag, realImag), cImag); // 2 * real * imag, the doubling is exact
+            real = _mm256_add_pd(_mm256_sub_pd(realSquared, imagSquared), cReal);
+
+            __m256d repeated = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(real, checkReal, _CMP_EQ_OQ), _mm256_cmp_pd(imag, checkImag, _CMP_EQ_OQ)), active);
+            stoppedAt = _mm256_blendv_pd(stoppedAt, n, repeated);
+            active = _mm256_andnot_pd(repeated, active);
+            if (iteration == nextCheck) { // All lanes started together, so they save at the same iterations
+                checkReal = real;
+                checkImag = imag;
+                nextCheck *= 2;
+            }
+            n = _mm256_add_pd(n, one);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm256_cvttpd_epi32(escapedAt));
+        alignas(32) double laneStoppedAt[LANES];
+        _mm256_store_pd(laneStoppedAt, stoppedAt);
+        int interiorMask = _mm256_movemask_pd(interior);
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if (result[i + lane] != 0)
+                statistics.iterations += result[i + lane];
+            else if (laneStoppedAt[lane] > 0.0) {
+                statistics.iterations += static_cast<std::uint64_t>(laneStoppedAt[lane]);
+                statistics.periodicPixels++;
+            }
+            else if ((interiorMask & (1 << lane)) == 0)
+                statistics.iterations += maxIterations;
+        }
+        statistics.laneSlots += steps * LANES;
+    }
+
+    iterateScalar(startReal + i, startImag + i, count - i, maxIterations, result + i, statistics);
+}
+
+void iterateStreamAvx2(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    constexpr std::size_t LANES = 4;
+    constexpr std::size_t NO_PIXEL = static_cast<std::size_t>(-1);
+    constexpr double IDLE = -1e300; // Iteration counter of a lane without pixel, never reaches the limit
+
+    if (maxIterations == 0) { // The refill logic assumes at least one iteration
+        iterateScalar(startReal, startImag, count, maxIterations, result, statistics);
+        return;
+    }
+
+    alignas(32) double laneReal[LANES];
+    alignas(32) double laneImag[LANES];
+    alignas(32) double laneCReal[LANES];
+    alignas(32) double laneCImag[LANES];
+    alignas(32) double laneN[LANES];
+    alignas(32) double laneCheckReal[LANES]; // Orbit value saved for the cycle detection
+    alignas(32) double laneCheckImag[LANES];
+    alignas(32) double laneNextCheck[LANES]; // Iteration after which the next value gets saved
+    std::size_t lanePixel[LANES];
+
+    std::size_t nextPixel = 0;
+    std::uint64_t busyLanes = 0;
+    auto fetchPixel = [&](std::size_t lane) {
+        // Pixels in the main cardioid or the period-2 bulb are settled right here and never take a lane
+        while (nextPixel < count && isInMainCardioidOrBulb(startReal[nextPixel], startImag[nextPixel])) {
+            result[nextPixel] = 0;
+            statistics.bulbPixels++;
+            nextPixel++;
+        }
+        if (nextPixel < count) {
+            lanePixel[lane] = nextPixel;
+            laneCheckReal[lane] = laneCReal[lane] = laneReal[lane] = startReal[nextPixel];
+            laneCheckImag[lane] = laneCImag[lane] = laneImag[lane] = startImag[nextPixel];
+            laneN[lane] = 1.0;
+            laneNextCheck[lane] = 1.0;
+            nextPixel++;
+            busyLanes++;
+        }
+        else {
+            lanePixel[lane] = NO_PIXEL;
+            laneCReal[lane] = laneReal[lane] = 0.0;
+            laneCImag[lane] = laneImag[lane] = 0.0;
+            laneCheckReal[lane] = laneCheckImag[lane] = std::numeric_limits<double>::quiet_NaN(); // The idle orbit 0 must not count as periodic
+            laneN[lane] = IDLE;
+            laneNextCheck[lane] = 0.0;
+        }
+    };
+    for (std::size_t lane = 0; lane < LANES; lane++)
+        fetchPixel(lane);
+
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d limit = _mm256_set1_pd(static_cast<double>(maxIterations));
+    __m256d real = _mm256_load_pd(laneReal);
+    __m256d imag = _mm256_load_pd(laneImag);
+    __m256d cReal = _mm256_load_pd(laneCReal);
+    __m256d cImag = _mm256_load_pd(laneCImag);
+    __m256d n = _mm256_load_pd(laneN);
+    __m256d checkReal = _mm256_load_pd(laneCheckReal);
+    __m256d checkImag = _mm256_load_pd(laneCheckImag);
+    __m256d nextCheck = _mm256_load_pd(laneNextCheck);
+
+    while (busyLanes > 0) {
+        statistics.iterations += busyLanes;
+        statistics.laneSlots += LANES;
+
+        __m256d realSquared = _mm256_mul_pd(real, real);
+        __m256d imagSquared = _mm256_mul_pd(imag, imag);
+        __m256d escaped = _mm256_cmp_pd(_mm256_add_pd(realSquared, imagSquared), four, _CMP_GT_OQ);
+        __m256d done = _mm256_or_pd(escaped, _mm256_cmp_pd(n, limit, _CMP_GE_OQ));
+
+        __m256d realImag = _mm256_mul_pd(real, imag);
+        imag = _mm256_add_pd(_mm256_add_pd(realImag, realImag), cImag); // 2 * real * imag, the doubling is exact
+        real = _mm256_add_pd(_mm256_sub_pd(realSquared, imagSquared), cReal);
+
+        // Each lane saves its orbit at its own iterations 1, 2, 4, 8, ...
+        __m256d repeated = _mm256_and_pd(_mm256_cmp_pd(real, checkReal, _CMP_EQ_OQ), _mm256_cmp_pd(imag, checkImag, _CMP_EQ_OQ));
+        __m256d save = _mm256_cmp_pd(n, nextCheck, _CMP_EQ_OQ);
+        checkReal = _mm256_blendv_pd(checkReal, real, save);
+        checkImag = _mm256_blendv_pd(checkImag, imag, save);
+        nextCheck = _mm256_blendv_pd(nextCheck, _mm256_add_pd(nextCheck, nextCheck), save);
+
+        int doneMask = _mm256_movemask_pd(_mm256_or_pd(done, repeated));
+        if (doneMask == 0) {
+            n = _mm256_add_pd(n, one);
+            continue;
+        }
+
+        // Write back finished pixels and refill their lanes from the queue
+        int escapedMask = _mm256_movemask_pd(escaped);
+        int repeatedMask = _mm256_movemask_pd(repeated);
+        _mm256_store_pd(laneReal, real);
+        _mm256_store_pd(laneImag, imag);
+        _mm256_store_pd(laneN, _mm256_add_pd(n, one));
+        _mm256_store_pd(laneCheckReal, checkReal);
+        _mm256_store_pd(laneCheckImag, checkImag);
+        _mm256_store_pd(laneNextCheck, nextCheck);
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if ((doneMask & (1 << lane)) == 0)
+                continue;
+            bool laneEscaped = (escapedMask & (1 << lane)) != 0;
+            result[lanePixel[lane]] = laneEscaped ? static_cast<std::uint32_t>(laneN[lane] - 1.0) : 0;
+            statistics.periodicPixels += !laneEscaped && (repeatedMask & (1 << lane)) != 0 ? 1 : 0;
+            busyLanes--;
+            fetchPixel(lane);
+        }
+        real = _mm256_load_pd(laneReal);
+        imag = _mm256_load_pd(laneImag);
+        cReal = _mm256_load_pd(laneCReal);
+        cImag = _mm256_load_pd(laneCImag);
+        n = _mm256_load_pd(laneN);
+        checkReal = _mm256_load_pd(laneCheckReal);
+        checkImag = _mm256_load_pd(laneCheckImag);
+        nextCheck = _mm256_load_pd(laneNextCheck);
+    }
+}
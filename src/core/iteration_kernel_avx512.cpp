@@ -0,0 +1,205 @@
+#include "iteration_kernel.h"
+
+#include <immintrin.h>
+#include <limits>
+
+// This file is compiled with -mavx512f and -ffp-contract=off (AVX-512F brings FMA along), so every lane does
+// exactly the same roundings as `calcMandel` and the results are bit-identical. The interior test
+// and the cycle detection of `calcMandel` are done per lane as well.
+
+void iterateAvx512(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    constexpr std::size_t LANES = 8;
+    const __m512d four = _mm512_set1_pd(4.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        const __m512d cReal = _mm512_loadu_pd(startReal + i);
+        const __m512d cImag = _mm512_loadu_pd(startImag + i);
+        __m512d real = cReal;
+        __m512d imag = cImag;
+        __m512d checkReal = real;
+        __m512d checkImag = imag;
+        __m512d escapedAt = _mm512_setzero_pd();
+        __mmask8 periodic = 0;
+        __m512d stoppedAt = _mm512_setzero_pd(); // Iteration in which a lane was found periodic
+        __m512d n = one;
+
+        // Lanes in the main cardioid or the period-2 bulb never become active
+        __mmask8 interior = 0;
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if (isInMainCardioidOrBulb(startReal[i + lane], startImag[i + lane]))
+                interior = static_cast<__mmask8>(interior | (1u << lane));
+        }
+        __mmask8 active = static_cast<__mmask8>(~interior);
+
+        std::uint64_t steps = 0;
+        unsigned int nextCheck = 1;
+        unsigned int iterationLimit = active == 0 ? 0 : maxIterations;
+        for (unsigned int iteration = 1; iteration < iterationLimit + 1; iteration++) {
+            steps++;
+            __m512d realSquared = _mm512_mul_pd(real, real);
+            __m512d imagSquared = _mm512_mul_pd(imag, imag);
+            __mmask8 escaped = _mm512_mask_cmp_pd_mask(active, _mm512_add_pd(realSquared, imagSquared), four, _CMP_GT_OQ);
+            escapedAt = _mm512_mask_mov_pd(escapedAt, escaped, n);
+            active = static_cast<__mmask8>(active & ~escaped);
+            if (active == 0)
+                break;
+
+            __m512d realImag = _mm512_mul_pd(real, imag);
+            imag = _mm512_add_pd(_mm512_add_pd(realImag, realImag), cImag); // 2 * real * imag, the doubling is exact
+            real = _mm512_add_pd(_mm512_sub_pd(realSquared, imagSquared), cReal);
+
+            __mmask8 repeated = static_cast<__mmask8>(_mm512_mask_cmp_pd_mask(active, real, checkReal, _CMP_EQ_OQ)
+                & _mm512_cmp_pd_mask(imag, checkImag, _CMP_EQ_OQ));
+            stoppedAt = _mm512_mask_mov_pd(stoppedAt, repeated, n);
+            periodic = static_cast<__mmask8>(periodic | repeated);
+            active = static_cast<__mmask8>(active & ~repeated);
+            if (iteration == nextCheck) { // All lanes started together, so they save at the same iterations
+                checkReal = real;
+                checkImag = imag;
+                nextCheck *= 2;
+            }
+            n = _mm512_add_pd(n, one);
+        }
+
+        // The zero-masking form with every lane set, the unmasked one passes an undefined vector GCC warns about
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), _mm512_maskz_cvttpd_epi32(static_cast<__mmask8>(0xFF), escapedAt));
+        alignas(64) double laneStoppedAt[LANES];
+        _mm512_store_pd(laneStoppedAt, stoppedAt);
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if (result[i + lane] != 0)
+                statistics.iterations += result[i + lane];
+            else if (periodic & (1u << lane)) {
+                statistics.iterations += static_cast<std::uint64_t>(laneStoppedAt[lane]);
+                statistics.periodicPixels++;
+            }
+            else if (interior & (1u << lane))
+                statistics.bulbPixels++;
+            else
+                statistics.iterations += maxIterations;
+        }
+        statistics.laneSlots += steps * LANES;
+    }
+
+    iterateScalar(startReal + i, startImag + i, count - i, maxIterations, result + i, statistics);
+}
+
+void iterateStreamAvx512(const double* startReal, const double* startImag, std::size_t count,
+    unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    constexpr std::size_t LANES = 8;
+    constexpr std::size_t NO_PIXEL = static_cast<std::size_t>(-1);
+    constexpr double IDLE = -1e300; // Iteration counter of a lane without pixel, never reaches the limit
+
+    if (maxIterations == 0) { // The refill logic assumes at least one iteration
+        iterateScalar(startReal, startImag, count, maxIterations, result, statistics);
+        return;
+    }
+
+    alignas(64) double laneReal[LANES];
+    alignas(64) double laneImag[LANES];
+    alignas(64) double laneCReal[LANES];
+    alignas(64) double laneCImag[LANES];
+    alignas(64) double laneN[LANES];
+    alignas(64) double laneCheckReal[LANES]; // Orbit value saved for the cycle detection
+    alignas(64) double laneCheckImag[LANES];
+    alignas(64) double laneNextCheck[LANES]; // Iteration after which the next value gets saved
+    std::size_t lanePixel[LANES];
+
+    std::size_t nextPixel = 0;
+    std::uint64_t busyLanes = 0;
+    auto fetchPixel = [&](std::size_t lane) {
+        // Pixels in the main cardioid or the period-2 bulb are settled right here and never take a lane
+        while (nextPixel < count && isInMainCardioidOrBulb(startReal[nextPixel], startImag[nextPixel])) {
+            result[nextPixel] = 0;
+            statistics.bulbPixels++;
+            nextPixel++;
+        }
+        if (nextPixel < count) {
+            lanePixel[lane] = nextPixel;
+            laneCheckReal[lane] = laneCReal[lane] = laneReal[lane] = startReal[nextPixel];
+            laneCheckImag[lane] = laneCImag[lane] = laneImag[lane] = startImag[nextPixel];
+            laneN[lane] = 1.0;
+            laneNextCheck[lane] = 1.0;
+            nextPixel++;
+            busyLanes++;
+        }
+        else {
+            lanePixel[lane] = NO_PIXEL;
+            laneCReal[lane] = laneReal[lane] = 0.0;
+            laneCImag[lane] = laneImag[lane] = 0.0;
+            laneCheckReal[lane] = laneCheckImag[lane] = std::numeric_limits<double>::quiet_NaN(); // The idle orbit 0 must not count as periodic
+            laneN[lane] = IDLE;
+            laneNextCheck[lane] = 0.0;
+        }
+    };
+    for (std::size_t lane = 0; lane < LANES; lane++)
+        fetchPixel(lane);
+
+    const __m512d four = _mm512_set1_pd(4.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d limit = _mm512_set1_pd(static_cast<double>(maxIterations));
+    __m512d real = _mm512_load_pd(laneReal);
+    __m512d imag = _mm512_load_pd(laneImag);
+    __m512d cReal = _mm512_load_pd(laneCReal);
+    __m512d cImag = _mm512_load_pd(laneCImag);
+    __m512d n = _mm512_load_pd(laneN);
+    __m512d checkReal = _mm512_load_pd(laneCheckReal);
+    __m512d checkImag = _mm512_load_pd(laneCheckImag);
+    __m512d nextCheck = _mm512_load_pd(laneNextCheck);
+
+    while (busyLanes > 0) {
+        statistics.iterations += busyLanes;
+        statistics.laneSlots += LANES;
+
+        __m512d realSquared = _mm512_mul_pd(real, real);
+        __m512d imagSquared = _mm512_mul_pd(imag, imag);
+        __mmask8 escaped = _mm512_cmp_pd_mask(_mm512_add_pd(realSquared, imagSquared), four, _CMP_GT_OQ);
+        __mmask8 done = static_cast<__mmask8>(escaped | _mm512_cmp_pd_mask(n, limit, _CMP_GE_OQ));
+
+        __m512d realImag = _mm512_mul_pd(real, imag);
+        imag = _mm512_add_pd(_mm512_add_pd(realImag, realImag), cImag); // 2 * real * imag, the doubling is exact
+        real = _mm512_add_pd(_mm512_sub_pd(realSquared, imagSquared), cReal);
+
+        // Each lane saves its orbit at its own iterations 1, 2, 4, 8, ...
+        __mmask8 repeated = static_cast<__mmask8>(_mm512_cmp_pd_mask(real, checkReal, _CMP_EQ_OQ) & _mm512_cmp_pd_mask(imag, checkImag, _CMP_EQ_OQ));
+        __mmask8 save = _mm512_cmp_pd_mask(n, nextCheck, _CMP_EQ_OQ);
+        checkReal = _mm512_mask_mov_pd(checkReal, save, real);
+        checkImag = _mm512_mask_mov_pd(checkImag, save, imag);
+        nextCheck = _mm512_mask_add_pd(nextCheck, save, nextCheck, nextCheck);
+        done = static_cast<__mmask8>(done | repeated);
+
+        if (done == 0) {
+            n = _mm512_add_pd(n, one);
+            continue;
+        }
+
+        // Write back finished pixels and refill their lanes from the queue
+        _mm512_store_pd(laneReal, real);
+        _mm512_store_pd(laneImag, imag);
+        _mm512_store_pd(laneN, _mm512_add_pd(n, one));
+        _mm512_store_pd(laneCheckReal, checkReal);
+        _mm512_store_pd(laneCheckImag, checkImag);
+        _mm512_store_pd(laneNextCheck, nextCheck);
+        for (std::size_t lane = 0; lane < LANES; lane++) {
+            if ((done & (1u << lane)) == 0)
+                continue;
+            bool laneEscaped = (escaped & (1u << lane)) != 0;
+            result[lanePixel[lane]] = laneEscaped ? static_cast<std::uint32_t>(laneN[lane] - 1.0) : 0;
+            statistics.periodicPixels += !laneEscaped && (repeated & (1u << lane)) != 0 ? 1 : 0;
+            busyLanes--;
+            fetchPixel(lane);
+        }
+        real = _mm512_load_pd(laneReal);
+        imag = _mm512_load_pd(laneImag);
+        cReal = _mm512_load_pd(laneCReal);
+        cImag = _mm512_load_pd(laneCImag);
+        n = _mm512_load_pd(laneN);
+        checkReal = _mm512_load_pd(laneCheckReal);
+        checkImag = _mm512_load_pd(laneCheckImag);
+        nextCheck = _mm512_load_pd(laneNextCheck);
+    }
+}
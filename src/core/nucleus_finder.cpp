@@ -0,0 +1,97 @@
+#include "nucleus_finder.h"
+
+#include <cmath>
+
+namespace {
+
+// Newton converges in a few steps from inside the atom domain, more steps mean it wanders between components
+constexpr int MAX_NEWTON_STEPS = 64;
+
+ComplexExp toComplexExp(const BigFixed& real, const BigFixed& imag) {
+    return {FloatExp::fromLongDouble(real.toLongDouble()), FloatExp::fromLongDouble(imag.toLongDouble())};
+}
+
+BigFixed toBigFixed(const FloatExp& value, int fractionLimbs) {
+    // The mantissa is exact at any precision, shifting it only drops the bits below the precision
+    return BigFixed{static_cast<long double>(value.mantissa), fractionLimbs}.scaledByPowerOfTwo(value.exponent);
+}
+
+/**
+ * `Z_(n+1) = Z_n^2 + C` with three multiplications, like `ReferenceOrbit::compute`
+ */
+void step(BigFixed& real, BigFixed& imag, const ComplexFixed& point) {
+    BigFixed realSquared = real.square();
+    BigFixed imagSquared = imag.square();
+    imag = (real * imag).scaledByPowerOfTwo(1) + point.imag;
+    real = realSquared - imagSquared + point.real;
+}
+
+} // namespace
+
+unsigned int findBallPeriod(const ComplexFixed& center, const FloatExp& radius, unsigned int maxIterations) {
+    // z_n(C + u) = Z_n + A_n u + E_n with |u| <= radius, A_n = dZ_n / dc and |E_n| <= error
+    BigFixed real = center.real;
+    BigFixed imag = center.imag;
+    ComplexExp derivative{FloatExp{1.0}, {}};
+    FloatExp error;
+    for (unsigned int n = 1; n <= maxIterations; n++) {
+        FloatExp magnitude = toComplexExp(real, imag).magnitude();
+        FloatExp linearRadius = derivative.magnitude() * radius;
+        FloatExp ballRadius = linearRadius + error;
+        if (magnitude.isSmallerThan(ballRadius))
+            return n;
+        if ((magnitude - ballRadius).toDouble() > 2.0) // Every point of the disk escaped
+            return 0;
+
+        // Squaring: A u squared goes into the error, which also grows with everything it gets multiplied with
+        error = linearRadius * linearRadius + (magnitude + linearRadius) * error * 2.0 + error * error;
+        derivative = derivative.multiplied(2.0 * real.toDouble(), 2.0 * imag.toDouble()) + ComplexExp{FloatExp{1.0}, {}};
+        step(real, imag, center);
+    }
+    return 0;
+}
+
+bool refineNucleus(ComplexFixed& nucleus, unsigned int period, const FloatExp& tolerance) {
+    int fractionLimbs = nucleus.real.getFractionLimbs();
+    for (int newtonStep = 0; newtonStep < MAX_NEWTON_STEPS; newtonStep++) {
+        // dZ_(n+1) / dc = 2 Z_n dZ_n / dc + 1, far beyond the range of double for deep minibrots
+        BigFixed real{0.0L, fractionLimbs};
+        BigFixed imag{0.0L, fractionLimbs};
+        ComplexExp derivative;
+        for (unsigned int n = 0; n < period; n++) {
+            derivative = derivative.multiplied(2.0 * real.toDouble(), 2.0 * imag.toDouble()) + ComplexExp{FloatExp{1.0}, {}};
+            step(real, imag, nucleus);
+        }
+        if (derivative.real.isZero() && derivative.imag.isZero())
+            return false;
+
+        ComplexExp correction = toComplexExp(real, imag) / derivative;
+        FloatExp size = correction.magnitude();
+        if (!std::isfinite(size.mantissa) || FloatExp{2.0}.isSmallerThan(size))
+            return false;
+        nucleus.real -= toBigFixed(correction.real, fractionLimbs);
+        nucleus.imag -= toBigFixed(correction.imag, fractionLimbs);
+        if (size.isSmallerThan(tolerance))
+            return true;
+    }
+    return false;
+}
+
+bool findNucleus(const ComplexFixed& center, long double radius, unsigned int maxIterations, Nucleus& result) {
+    FloatExp searchRadius = FloatExp::fromLongDouble(radius);
+    unsigned int period = findBallPeriod(center, searchRadius, maxIterations);
+    if (period == 0)
+        return false;
+
+    // Newton stops far below the radius, which leaves Z_period tiny next to the deltas of the pixels
+    ComplexFixed nucleus = center;
+    if (!refineNucleus(nucleus, period, searchRadius.scaledByPowerOfTwo(-64)))
+        return false;
+
+    // Newton may have converged to a nucleus of the same period outside the disk
+    long double distance = std::hypot((nucleus.real - center.real).toLongDouble(), (nucleus.imag - center.imag).toLongDouble());
+    if (distance > radius)
+        return false;
+    result = {nucleus, period};
+    return true;
+}
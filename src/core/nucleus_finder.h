@@ -0,0 +1,46 @@
+#pragma once
+#ifndef MANDELBROT_NUCLEUSFINDER_INCLUDED
+#define MANDELBROT_NUCLEUSFINDER_INCLUDED
+
+#include "big_fixed.h"
+#include "float_exp.h"
+
+/**
+ * Center of a minibrot (hyperbolic component): the point whose orbit comes back to exactly 0 after `period` iterations
+ */
+struct Nucleus {
+    ComplexFixed center;
+    unsigned int period = 0;
+};
+
+/**
+ * Finds the lowest period of a nucleus that may lie within `radius` of `center`
+ *
+ * A ball that holds the orbit points of every point of the disk is iterated along with the orbit of `center`.
+ * It is kept as the linear part `Z_n + dZ_n / dc * u` plus an error radius for the rest, which grows far slower
+ * than the radius of a plain ball. The first `n` where the ball contains 0 is the period of the largest minibrot
+ * in the disk.
+ *
+ * @return The period, 0 if the ball escaped or `maxIterations` passed before it reached 0
+ */
+unsigned int findBallPeriod(const ComplexFixed& center, const FloatExp& radius, unsigned int maxIterations);
+
+/**
+ * Moves `nucleus` onto the nucleus of period `period` near it with Newton's method on `Z_period(c) = 0`
+ *
+ * The orbit is iterated with the precision of `nucleus`, its derivative in `FloatExp`, which is all the
+ * precision the steps need.
+ *
+ * @param tolerance Newton stops once a step is smaller than this
+ * @return Whether the steps converged
+ */
+bool refineNucleus(ComplexFixed& nucleus, unsigned int period, const FloatExp& tolerance);
+
+/**
+ * Finds the nucleus of the largest minibrot within `radius` of `center`, `findBallPeriod` followed by `refineNucleus`
+ *
+ * @return Whether a nucleus was found, it lies within `radius` of `center` and has the precision of `center`
+ */
+bool findNucleus(const ComplexFixed& center, long double radius, unsigned int maxIterations, Nucleus& result);
+
+#endif
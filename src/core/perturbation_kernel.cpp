@@ -0,0 +1,271 @@
+#include "perturbation_kernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * `calcMandelPerturbed` for either kind of orbit reader, which starts at `start.orbitIndex`
+ */
+template<class OrbitReader>
+std::uint32_t perturbedLoop(OrbitReader orbit, std::size_t last, bool truncated, double deltaReal, double deltaImag, unsigned int maxIterations,
+    const PerturbationStart& start, bool* glitched)
+{
+    double real = start.real; // Offset to the reference orbit
+    double imag = start.imag;
+    for (std::uint32_t n = start.iteration + 1; n < maxIterations + 1; n++) {
+        double orbitReal = orbit.getReal();
+        double orbitImag = orbit.getImag();
+        double nextReal = 2.0 * (orbitReal * real - orbitImag * imag) + (real * real - imag * imag) + deltaReal;
+        double nextImag = 2.0 * (orbitReal * imag + orbitImag * real) + 2.0 * real * imag + deltaImag;
+        orbit.advance();
+        orbitReal = orbit.getReal();
+        orbitImag = orbit.getImag();
+
+        double fullReal = orbitReal + nextReal;
+        double fullImag = orbitImag + nextImag;
+        double fullNorm = fullReal * fullReal + fullImag * fullImag;
+        if (fullNorm > 4.0)
+            return n;
+        if (glitched && fullNorm < GLITCH_TOLERANCE * (orbitReal * orbitReal + orbitImag * orbitImag)) {
+            *glitched = true;
+            return n;
+        }
+
+        if (orbit.getIndex() == last) { // Out of reference orbit, continue with Z_0 = 0 as the reference
+            // After the end of a truncated orbit the delta would be the full value, far too coarse for the pixel
+            if (truncated && glitched) {
+                *glitched = true;
+                return n;
+            }
+            real = fullReal;
+            imag = fullImag;
+            orbit.rebase();
+        }
+        else {
+            real = nextReal;
+            imag = nextImag;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+std::uint32_t calcMandelPerturbed(const ReferenceOrbit& reference, double deltaReal, double deltaImag, unsigned int maxIterations,
+    const PerturbationStart& start, bool* glitched)
+{
+    const std::size_t last = reference.size() - 1;
+    if (reference.isCompressed()) {
+        return perturbedLoop(CompressedOrbitReader{reference, start.orbitIndex}, last, reference.isTruncated(), deltaReal, deltaImag, maxIterations,
+            start, glitched);
+    }
+    return perturbedLoop(DenseOrbitReader{reference, start.orbitIndex}, last, false, deltaReal, deltaImag, maxIterations, start, glitched);
+}
+
+void iteratePerturbation(const ReferenceOrbit& reference, const SeriesApproximation* series, const FloatExp& deltaScale,
+    const double* deltaReal, const double* deltaImag, std::size_t count, unsigned int maxIterations, std::uint32_t* result,
+    KernelStatistics& statistics, std::uint8_t* glitched)
+{
+    std::uint32_t skip = series ? series->getSkipIterations() : 0;
+    bool rescaled = deltaScale.exponent < RESCALED_DELTA_EXPONENT;
+    double scale = deltaScale.toDouble();
+    for (std::size_t i = 0; i < count; i++) {
+        ComplexExp startDelta;
+        if (skip > 0)
+            startDelta = series->evaluate(deltaReal[i], deltaImag[i]);
+
+        bool pixelGlitched = false;
+        bool* glitchFlag = glitched ? &pixelGlitched : nullptr;
+        if (rescaled) {
+            std::uint64_t steps = 0;
+            result[i] = calcMandelRescaled(reference, nullptr, deltaScale, deltaReal[i], deltaImag[i], maxIterations, skip, startDelta, steps, glitchFlag);
+        }
+        else {
+            PerturbationStart start{skip, skip, startDelta.real.toDouble(), startDelta.imag.toDouble()};
+            result[i] = calcMandelPerturbed(reference, scale * deltaReal[i], scale * deltaImag[i], maxIterations, start, glitchFlag);
+        }
+        if (glitched)
+            glitched[i] = pixelGlitched ? 1 : 0;
+        std::uint64_t iterations = (result[i] == 0 ? maxIterations : result[i]) - skip;
+        statistics.iterations += iterations;
+        statistics.laneSlots += iterations;
+    }
+}
+
+std::uint32_t calcMandelBla(const ReferenceOrbit& reference, const BlaTable& table, double deltaReal, double deltaImag,
+    unsigned int maxIterations, std::uint64_t& steps, const PerturbationStart& start)
+{
+    const double* orbitReal = reference.getReal();
+    const double* orbitImag = reference.getImag();
+    const std::size_t last = reference.size() - 1;
+
+    double real = start.real;
+    double imag = start.imag;
+    std::size_t m = start.orbitIndex;
+    std::uint32_t n = start.iteration;
+    steps = 0;
+    while (n < maxIterations) {
+        steps++;
+        const BlaStep* step = nullptr;
+        std::uint32_t skip = table.lookup(m, real * real + imag * imag, maxIterations - n, step);
+        if (skip > 0) {
+            double nextReal = step->aReal * real - step->aImag * imag + step->bReal * deltaReal - step->bImag * deltaImag;
+            double nextImag = step->aReal * imag + step->aImag * real + step->bReal * deltaImag + step->bImag * deltaReal;
+            real = nextReal;
+            imag = nextImag;
+        }
+        else {
+            skip = 1;
+            double nextReal = 2.0 * (orbitReal[m] * real - orbitImag[m] * imag) + (real * real - imag * imag) + deltaReal;
+            double nextImag = 2.0 * (orbitReal[m] * imag + orbitImag[m] * real) + 2.0 * real * imag + deltaImag;
+            real = nextReal;
+            imag = nextImag;
+        }
+        m += skip;
+        n += skip;
+
+        double fullReal = orbitReal[m] + real;
+        double fullImag = orbitImag[m] + imag;
+        double fullNorm = fullReal * fullReal + fullImag * fullImag;
+        if (fullNorm > 4.0)
+            return n;
+
+        if (m == last || fullNorm < real * real + imag * imag) {
+            real = fullReal;
+            imag = fullImag;
+            m = 0;
+        }
+    }
+    return 0;
+}
+
+namespace {
+
+/**
+ * @return The larger exponent of the parts of `value` that are not 0, `fallback` if both are 0
+ */
+std::int32_t commonExponent(const ComplexExp& value, std::int32_t fallback) {
+    if (value.real.isZero())
+        return value.imag.isZero() ? fallback : value.imag.exponent;
+    return value.imag.isZero() ? value.real.exponent : std::max(value.real.exponent, value.imag.exponent);
+}
+
+/**
+ * `calcMandelRescaled` for either kind of orbit reader, which starts at `startIteration`, BLA steps need a dense orbit
+ */
+template<class OrbitReader>
+std::uint32_t rescaledLoop(OrbitReader orbit, const ReferenceOrbit& reference, const BlaTable* table, const FloatExp& deltaScale, double deltaReal,
+    double deltaImag, unsigned int maxIterations, std::uint32_t startIteration, const ComplexExp& startDelta, std::uint64_t& steps,
+    bool* glitched)
+{
+    const std::size_t last = reference.size() - 1;
+
+    // The delta is 2^scale * (real + i imag), the pixel offset 2^scale * (offsetReal + i offsetImag)
+    std::int32_t scale = commonExponent(startDelta, deltaScale.exponent);
+    double real = startDelta.real.scaledByPowerOfTwo(-scale).toDouble();
+    double imag = startDelta.imag.scaledByPowerOfTwo(-scale).toDouble();
+    double offsetFactor = deltaScale.scaledByPowerOfTwo(-scale).toDouble();
+    double offsetReal = offsetFactor * deltaReal;
+    double offsetImag = offsetFactor * deltaImag;
+
+    std::uint32_t n = startIteration;
+    steps = 0;
+    while (n < maxIterations && scale < RESCALED_DELTA_EXPONENT) {
+        steps++;
+        const BlaStep* step = nullptr;
+        // |delta|^2 is far below the range of double and compares as 0 against the radius of the steps
+        std::uint32_t skip = table ? table->lookup(orbit.getIndex(), 0.0, maxIterations - n, step) : 0;
+        if (skip > 0) {
+            double nextReal = step->aReal * real - step->aImag * imag + step->bReal * offsetReal - step->bImag * offsetImag;
+            double nextImag = step->aReal * imag + step->aImag * real + step->bReal * offsetImag + step->bImag * offsetReal;
+            real = nextReal;
+            imag = nextImag;
+        }
+        else {
+            skip = 1;
+            double nextReal = 2.0 * (orbit.getReal() * real - orbit.getImag() * imag) + offsetReal;
+            double nextImag = 2.0 * (orbit.getReal() * imag + orbit.getImag() * real) + offsetImag;
+            real = nextReal;
+            imag = nextImag;
+        }
+        orbit.advanceBy(skip);
+        n += skip;
+
+        // The delta does not change the full value Z_m + delta at double precision
+        if (orbit.getReal() * orbit.getReal() + orbit.getImag() * orbit.getImag() > 4.0)
+            return n;
+        if (orbit.getIndex() == last) { // Rebased onto Z_0 = 0, the delta becomes the full value
+            if (reference.isTruncated() && glitched) {
+                *glitched = true;
+                return n;
+            }
+            // Usually in range of double, but at the end of a periodic orbit Z_m is near 0 and the delta still counts
+            ComplexExp full{FloatExp{orbit.getReal()} + FloatExp{real, scale}, FloatExp{orbit.getImag()} + FloatExp{imag, scale}};
+            scale = commonExponent(full, scale);
+            real = full.real.scaledByPowerOfTwo(-scale).toDouble();
+            imag = full.imag.scaledByPowerOfTwo(-scale).toDouble();
+            offsetFactor = deltaScale.scaledByPowerOfTwo(-scale).toDouble();
+            offsetReal = offsetFactor * deltaReal;
+            offsetImag = offsetFactor * deltaImag;
+            orbit.rebase();
+            continue;
+        }
+
+        double magnitude = std::max(std::fabs(real), std::fabs(imag));
+        if ((magnitude > 0x1p32 || magnitude < 0x1p-32) && magnitude > 0.0) {
+            int shift = std::ilogb(magnitude);
+            real = std::ldexp(real, -shift);
+            imag = std::ldexp(imag, -shift);
+            offsetReal = std::ldexp(offsetReal, -shift);
+            offsetImag = std::ldexp(offsetImag, -shift);
+            scale += shift;
+        }
+    }
+    if (n >= maxIterations)
+        return 0;
+
+    // The delta is in range of double now, the pixel offset itself may still be below it and become 0, which does not matter next to the delta
+    PerturbationStart start{n, orbit.getIndex(), std::ldexp(real, scale), std::ldexp(imag, scale)};
+    double offsetScale = deltaScale.toDouble();
+    if (table) {
+        std::uint64_t remainingSteps = 0;
+        std::uint32_t escaped = calcMandelBla(reference, *table, offsetScale * deltaReal, offsetScale * deltaImag, maxIterations, remainingSteps, start);
+        steps += remainingSteps;
+        return escaped;
+    }
+    std::uint32_t escaped = calcMandelPerturbed(reference, offsetScale * deltaReal, offsetScale * deltaImag, maxIterations, start, glitched);
+    steps += (escaped == 0 ? maxIterations : escaped) - n;
+    return escaped;
+}
+
+} // namespace
+
+std::uint32_t calcMandelRescaled(const ReferenceOrbit& reference, const BlaTable* table, const FloatExp& deltaScale, double deltaReal,
+    double deltaImag, unsigned int maxIterations, std::uint32_t startIteration, const ComplexExp& startDelta, std::uint64_t& steps,
+    bool* glitched)
+{
+    if (reference.isCompressed()) {
+        return rescaledLoop(CompressedOrbitReader{reference, startIteration}, reference, nullptr, deltaScale, deltaReal, deltaImag, maxIterations,
+            startIteration, startDelta, steps, glitched);
+    }
+    return rescaledLoop(DenseOrbitReader{reference, startIteration}, reference, table, deltaScale, deltaReal, deltaImag, maxIterations,
+        startIteration, startDelta, steps, glitched);
+}
+
+void iterateBla(const ReferenceOrbit& reference, const BlaTable& table, const FloatExp& deltaScale, const double* deltaReal,
+    const double* deltaImag, std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics)
+{
+    bool rescaled = deltaScale.exponent < RESCALED_DELTA_EXPONENT;
+    double scale = deltaScale.toDouble();
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint64_t steps = 0;
+        if (rescaled)
+            result[i] = calcMandelRescaled(reference, &table, deltaScale, deltaReal[i], deltaImag[i], maxIterations, 0, {}, steps);
+        else
+            result[i] = calcMandelBla(reference, table, scale * deltaReal[i], scale * deltaImag[i], maxIterations, steps);
+        statistics.iterations += steps;
+        statistics.laneSlots += steps;
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#ifndef MANDELBROT_PERTURBATIONKERNEL_INCLUDED
+#define MANDELBROT_PERTURBATIONKERNEL_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iteration_kernel.h"
+#include "float_exp.h"
+#include "reference_orbit.h"
+#include "series_approximation.h"
+#include "bla_table.h"
+
+/**
+ * Binary exponent below which deltas leave the comfortable range of `double`
+ *
+ * Frames whose `deltaScale` is below `2^RESCALED_DELTA_EXPONENT` iterate their pixels rescaled (see `calcMandelRescaled`),
+ * everything else uses plain `double` deltas.
+ */
+constexpr std::int32_t RESCALED_DELTA_EXPONENT = -900;
+
+/**
+ * Pauldelbrot's glitch criterion: a pixel is glitched once `|Z_m + d|^2 < GLITCH_TOLERANCE * |Z_m|^2`
+ *
+ * The full value is then so much smaller than the reference that the delta has lost its precision relative to it,
+ * and the pixel needs a reference of its own.
+ */
+constexpr double GLITCH_TOLERANCE = 1e-6;
+
+/**
+ * Where a perturbed pixel continues: iteration `iteration`, with the delta `real + i imag` to the orbit point `orbitIndex`
+ */
+struct PerturbationStart {
+    std::uint32_t iteration = 0;
+    std::size_t orbitIndex = 0;
+    double real = 0.0;
+    double imag = 0.0;
+};
+
+/**
+ * `calcMandel` for the point `C + delta`, where `C` is the center of `reference`
+ *
+ * Only the difference to the reference orbit is iterated (`d_(n+1) = 2 Z_n d_n + d_n^2 + delta`), so `double`
+ * is enough no matter how small `delta` is. When the pixel outlives the reference orbit, the delta is rebased
+ * onto the start of the orbit (`d = Z_m + d`, `m = 0`).
+ *
+ * @param start Iteration the pixel has already reached (for example from a `SeriesApproximation`),
+ *              its orbit index has to be less than `reference.size() - 1`
+ * @param glitched If not null, the pixel stops at the first iteration that fails `GLITCH_TOLERANCE`, or at the end of a truncated
+ *                 orbit, and this is set to true
+ * @return Returns the iteration in which the point escaped (starting at 1), or 0 if it did not escape within `maxIterations`
+ */
+std::uint32_t calcMandelPerturbed(const ReferenceOrbit& reference, double deltaReal, double deltaImag, unsigned int maxIterations,
+    const PerturbationStart& start = {}, bool* glitched = nullptr);
+
+/**
+ * `calcMandelPerturbed` that jumps ahead with the steps of `table` whenever the delta is small enough
+ *
+ * The delta is rebased onto the start of the orbit whenever the full value gets smaller than the delta,
+ * so the pixel never drifts away from the reference.
+ *
+ * @param steps Receives the number of steps (single iterations and jumps) that were executed
+ */
+std::uint32_t calcMandelBla(const ReferenceOrbit& reference, const BlaTable& table, double deltaReal, double deltaImag,
+    unsigned int maxIterations, std::uint64_t& steps, const PerturbationStart& start = {});
+
+/**
+ * Perturbation for pixel offsets below the range of `double`, `delta = deltaScale * (deltaReal + i deltaImag)`
+ *
+ * The delta is kept as `2^scale * d` with a `double` `d` that is renormalized only when it leaves [2^-32, 2^32],
+ * so the loop is plain `double` arithmetic. `d_n^2` is dropped, it is far below the precision of `2 Z_n d_n`.
+ * Once the delta grows above `2^RESCALED_DELTA_EXPONENT` the pixel continues with `calcMandelPerturbed` or `calcMandelBla`.
+ *
+ * @param table If not null, BLA steps are used
+ * @param startIteration Iteration the pixel has already reached, `startDelta` is its delta
+ * @param steps Receives the number of steps (single iterations and jumps) that were executed
+ * @param glitched Passed on to `calcMandelPerturbed` (the rescaled part itself cannot glitch, its delta is far below `Z_m`)
+ */
+std::uint32_t calcMandelRescaled(const ReferenceOrbit& reference, const BlaTable* table, const FloatExp& deltaScale, double deltaReal,
+    double deltaImag, unsigned int maxIterations, std::uint32_t startIteration, const ComplexExp& startDelta, std::uint64_t& steps,
+    bool* glitched = nullptr);
+
+/**
+ * Perturbation counterpart of `IterationKernel`, the points are given as offsets `deltaScale * (deltaReal + i deltaImag)`
+ * to the center of `reference`
+ *
+ * @param series If not null, every point starts at the skip iteration of the series, skipped iterations are not counted in `statistics`
+ * @param deltaScale Power of two, chosen so the offsets are around 1, pixels of frames below `2^RESCALED_DELTA_EXPONENT` are
+ *                   iterated with `calcMandelRescaled`
+ * @param glitched If not null, receives 1 for every point that glitched (its result is not valid) and 0 for the others
+ */
+void iteratePerturbation(const ReferenceOrbit& reference, const SeriesApproximation* series, const FloatExp& deltaScale,
+    const double* deltaReal, const double* deltaImag, std::size_t count, unsigned int maxIterations, std::uint32_t* result,
+    KernelStatistics& statistics, std::uint8_t* glitched = nullptr);
+
+/**
+ * `iteratePerturbation` with `calcMandelBla`, counts executed steps instead of iterations in `statistics`
+ */
+void iterateBla(const ReferenceOrbit& reference, const BlaTable& table, const FloatExp& deltaScale, const double* deltaReal,
+    const double* deltaImag, std::size_t count, unsigned int maxIterations, std::uint32_t* result, KernelStatistics& statistics);
+
+#endif
@@ -0,0 +1,137 @@
+#include "reference_orbit.h"
+
+#include <algorithm>
+#include <cmath>
+
+void ReferenceOrbit::compute(const ComplexFixed& referenceCenter, unsigned int maxIterations, std::size_t memoryLimit) {
+    center = referenceCenter;
+    centerReal = center.real.toDouble();
+    centerImag = center.imag.toDouble();
+    orbitReal.assign(1, 0.0);
+    orbitImag.assign(1, 0.0);
+    // Growing by doubling would overshoot the limit, the reservation stops at the point where the orbit gets compressed
+    std::size_t denseLimit = memoryLimit / (2 * sizeof(double)) + 1;
+    orbitReal.reserve(std::min<std::size_t>(std::size_t{maxIterations} + 1, denseLimit));
+    orbitImag.reserve(std::min<std::size_t>(std::size_t{maxIterations} + 1, denseLimit));
+    waypoints.clear();
+    length = 1;
+    escaped = false;
+    compressed = false;
+    truncated = false;
+    period = 0;
+
+    // State of the regenerated orbit once compressed
+    double shadowReal = 0.0;
+    double shadowImag = 0.0;
+
+    BigFixed real = center.real;
+    BigFixed imag = center.imag;
+    for (unsigned int n = 1; n <= maxIterations; n++) {
+        double realValue = real.toDouble();
+        double imagValue = imag.toDouble();
+        if (!compressed) {
+            orbitReal.push_back(realValue);
+            orbitImag.push_back(imagValue);
+            length++;
+            if (2 * sizeof(double) * length > memoryLimit && !compress(shadowReal, shadowImag, memoryLimit))
+                return;
+        }
+        else {
+            stepDouble(shadowReal, shadowImag, centerReal, centerImag);
+            double errorReal = shadowReal - realValue;
+            double errorImag = shadowImag - imagValue;
+            double norm = realValue * realValue + imagValue * imagValue;
+            if (!(errorReal * errorReal + errorImag * errorImag <= WAYPOINT_TOLERANCE * WAYPOINT_TOLERANCE * norm)) {
+                if (sizeof(Waypoint) * (waypoints.size() + 1) > memoryLimit) {
+                    truncated = true;
+                    return;
+                }
+                waypoints.push_back({n, realValue, imagValue});
+                shadowReal = realValue;
+                shadowImag = imagValue;
+            }
+            length++;
+        }
+
+        if (realValue * realValue + imagValue * imagValue > 4.0) {
+            escaped = true;
+            return;
+        }
+
+        // Three multiplications per step: real^2, imag^2 and real * imag
+        BigFixed realSquared = real.square();
+        BigFixed imagSquared = imag.square();
+        imag = (real * imag).scaledByPowerOfTwo(1) + center.imag;
+        real = realSquared - imagSquared + center.real;
+    }
+}
+
+void ReferenceOrbit::computePeriodic(const ComplexFixed& nucleus, unsigned int nucleusPeriod, std::size_t memoryLimit) {
+    compute(nucleus, nucleusPeriod, memoryLimit);
+    period = nucleusPeriod;
+}
+
+bool ReferenceOrbit::compress(double& shadowReal, double& shadowImag, std::size_t memoryLimit) {
+    shadowReal = 0.0;
+    shadowImag = 0.0;
+    bool complete = true;
+    for (std::size_t n = 1; n < orbitReal.size(); n++) {
+        stepDouble(shadowReal, shadowImag, centerReal, centerImag);
+        double errorReal = shadowReal - orbitReal[n];
+        double errorImag = shadowImag - orbitImag[n];
+        double norm = orbitReal[n] * orbitReal[n] + orbitImag[n] * orbitImag[n];
+        if (!(errorReal * errorReal + errorImag * errorImag <= WAYPOINT_TOLERANCE * WAYPOINT_TOLERANCE * norm)) {
+            if (sizeof(Waypoint) * (waypoints.size() + 1) > memoryLimit) {
+                length = n;
+                truncated = true;
+                complete = false;
+                break;
+            }
+            waypoints.push_back({n, orbitReal[n], orbitImag[n]});
+            shadowReal = orbitReal[n];
+            shadowImag = orbitImag[n];
+        }
+    }
+    std::vector<double>{}.swap(orbitReal);
+    std::vector<double>{}.swap(orbitImag);
+    compressed = true;
+    return complete;
+}
+
+std::size_t ReferenceOrbit::getBytes() const {
+    return compressed ? waypoints.size() * sizeof(Waypoint) : 2 * sizeof(double) * orbitReal.size();
+}
+
+CompressedOrbitReader::CompressedOrbitReader(const ReferenceOrbit& reference, std::size_t start)
+    : waypoints{reference.getWaypoints().data()}, waypointCount{reference.getWaypoints().size()},
+    centerReal{reference.getCenterReal()}, centerImag{reference.getCenterImag()}
+{
+    // Continue from the last waypoint at or before the start, or from Z_0
+    const std::vector<ReferenceOrbit::Waypoint>& all = reference.getWaypoints();
+    auto after = std::upper_bound(all.begin(), all.end(), start,
+        [](std::size_t iteration, const ReferenceOrbit::Waypoint& waypoint) { return iteration < waypoint.iteration; });
+    if (after != all.begin()) {
+        const ReferenceOrbit::Waypoint& waypoint = *(after - 1);
+        index = static_cast<std::size_t>(waypoint.iteration);
+        real = waypoint.real;
+        imag = waypoint.imag;
+    }
+    nextWaypoint = static_cast<std::size_t>(after - all.begin());
+    advanceBy(start - index);
+}
+
+std::uint32_t calcMandelBigFixed(const ComplexFixed& point, unsigned int maxIterations) {
+    BigFixed real = point.real;
+    BigFixed imag = point.imag;
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        double realValue = real.toDouble();
+        double imagValue = imag.toDouble();
+        if (realValue * realValue + imagValue * imagValue > 4.0)
+            return n;
+        BigFixed realSquared = real.square();
+        BigFixed imagSquared = imag.square();
+        imag = (real * imag).scaledByPowerOfTwo(1) + point.imag;
+        real = realSquared - imagSquared + point.real;
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+#pragma once
+#ifndef MANDELBROT_REFERENCEORBIT_INCLUDED
+#define MANDELBROT_REFERENCEORBIT_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "big_fixed.h"
+
+/**
+ * High-precision orbit of a single point, the reference every pixel of a perturbation frame is iterated against
+ *
+ * The orbit `Z_0 = 0, Z_(n+1) = Z_n^2 + C` is computed with `BigFixed` and stored as `double`, which is all the
+ * precision the per-pixel deltas need. It stops after `maxIterations` steps or once the orbit escaped.
+ *
+ * Orbits that would take more than the memory limit are stored compressed: the orbit is regenerated by iterating
+ * in `double` from `C`, and only the waypoints where that drifts away from the exact orbit keep their exact value.
+ * This is lossy: regenerated points may be off by `WAYPOINT_TOLERANCE` relative, about 32 times the rounding of
+ * the dense orbit, so a few pixels near the boundary can get other counts than with the dense orbit. A lossless
+ * store would not be smaller, the double iteration misses the rounded exact value on most steps.
+ *
+ * Readers (`DenseOrbitReader`, `CompressedOrbitReader`) walk the orbit point by point in both cases. If even the
+ * waypoints outgrow the limit, the orbit is cut short there and pixels that outlive it count as glitched.
+ *
+ * The orbit of a minibrot nucleus (`computePeriodic`) comes back to `Z_period = 0`. The kernels rebase onto `Z_0`
+ * at the end of every orbit, so one period serves any number of iterations.
+ */
+class ReferenceOrbit {
+
+public:
+    /**
+     * Exact value of the orbit point `iteration`, the regenerated orbit continues from it
+     */
+    struct Waypoint {
+        std::uint64_t iteration;
+        double real;
+        double imag;
+    };
+
+    /**
+     * Relative error the regenerated orbit may reach before the next waypoint is stored
+     */
+    static constexpr double WAYPOINT_TOLERANCE = 0x1p-48;
+
+protected:
+    ComplexFixed center;
+    double centerReal = 0.0; // C rounded to double, the regenerated orbit is iterated with it
+    double centerImag = 0.0;
+    std::vector<double> orbitReal; // Z_0 ... Z_n, empty if compressed
+    std::vector<double> orbitImag;
+    std::vector<Waypoint> waypoints; // Ordered by iteration, only if compressed
+    std::size_t length = 0;
+    bool escaped = false;
+    bool compressed = false;
+    bool truncated = false;
+    unsigned int period = 0;
+
+public:
+    /**
+     * Step of the regenerated orbit, the same function computes it when compressing and when reading
+     */
+    static inline void stepDouble(double& real, double& imag, double cReal, double cImag) {
+        double nextReal = real * real - imag * imag + cReal;
+        imag = 2.0 * real * imag + cImag;
+        real = nextReal;
+    }
+
+    /**
+     * @param referenceCenter The point C, its precision is used for the whole orbit
+     * @param memoryLimit Bytes the stored orbit may take, dense orbits above it are compressed
+     */
+    void compute(const ComplexFixed& referenceCenter, unsigned int maxIterations, std::size_t memoryLimit = SIZE_MAX);
+
+    /**
+     * Computes one period of the orbit of a nucleus, `Z_0 ... Z_period`
+     */
+    void computePeriodic(const ComplexFixed& nucleus, unsigned int nucleusPeriod, std::size_t memoryLimit = SIZE_MAX);
+
+    /**
+     * @return Number of stored orbit points, `Z_0` included
+     */
+    inline std::size_t size() const { return length; }
+
+    /**
+     * @return The dense orbit, null if it is compressed
+     */
+    inline const double* getReal() const { return compressed ? nullptr : orbitReal.data(); }
+    inline const double* getImag() const { return compressed ? nullptr : orbitImag.data(); }
+
+    inline const ComplexFixed& getCenter() const { return center; }
+    inline double getCenterReal() const { return centerReal; }
+    inline double getCenterImag() const { return centerImag; }
+    inline const std::vector<Waypoint>& getWaypoints() const { return waypoints; }
+
+    /**
+     * @return Whether the last stored point lies outside the escape radius
+     */
+    inline bool hasEscaped() const { return escaped; }
+
+    inline bool isCompressed() const { return compressed; }
+
+    /**
+     * @return Whether the orbit stops early because it reached the memory limit
+     */
+    inline bool isTruncated() const { return truncated; }
+
+    /**
+     * @return The period of the nucleus the orbit belongs to, 0 if it is not periodic
+     */
+    inline unsigned int getPeriod() const { return period; }
+
+    /**
+     * @return Memory of the stored orbit
+     */
+    std::size_t getBytes() const;
+
+protected:
+    /**
+     * Replaces the dense orbit by waypoints
+     *
+     * @param shadowReal, shadowImag Receive the regenerated value of the last point, the orbit continues from it
+     * @return False if the waypoints outgrew `memoryLimit`, the orbit is then truncated before that point
+     */
+    bool compress(double& shadowReal, double& shadowImag, std::size_t memoryLimit);
+
+};
+
+/**
+ * Walks a dense `ReferenceOrbit`
+ */
+class DenseOrbitReader {
+
+protected:
+    const double* orbitReal;
+    const double* orbitImag;
+    std::size_t index;
+
+public:
+    DenseOrbitReader(const ReferenceOrbit& reference, std::size_t start) : orbitReal{reference.getReal()}, orbitImag{reference.getImag()}, index{start} {}
+
+    inline std::size_t getIndex() const { return index; }
+    inline double getReal() const { return orbitReal[index]; }
+    inline double getImag() const { return orbitImag[index]; }
+    inline void advance() { index++; }
+    inline void advanceBy(std::size_t steps) { index += steps; }
+    inline void rebase() { index = 0; }
+
+};
+
+/**
+ * Walks a compressed `ReferenceOrbit` by regenerating it in `double` between the waypoints
+ */
+class CompressedOrbitReader {
+
+protected:
+    const ReferenceOrbit::Waypoint* waypoints;
+    std::size_t waypointCount;
+    std::size_t nextWaypoint = 0;
+    double centerReal;
+    double centerImag;
+    std::size_t index = 0;
+    double real = 0.0;
+    double imag = 0.0;
+
+public:
+    /**
+     * Starts at the orbit point `start`, regenerated from the last waypoint before it
+     */
+    CompressedOrbitReader(const ReferenceOrbit& reference, std::size_t start);
+
+    inline std::size_t getIndex() const { return index; }
+    inline double getReal() const { return real; }
+    inline double getImag() const { return imag; }
+
+    inline void advance() {
+        index++;
+        if (nextWaypoint < waypointCount && waypoints[nextWaypoint].iteration == index) {
+            real = waypoints[nextWaypoint].real;
+            imag = waypoints[nextWaypoint].imag;
+            nextWaypoint++;
+        }
+        else
+            ReferenceOrbit::stepDouble(real, imag, centerReal, centerImag);
+    }
+
+    inline void advanceBy(std::size_t steps) {
+        for (std::size_t i = 0; i < steps; i++)
+            advance();
+    }
+
+    inline void rebase() {
+        index = 0;
+        real = 0.0;
+        imag = 0.0;
+        nextWaypoint = 0;
+    }
+
+};
+
+/**
+ * `calcMandel` of a single point, iterated in `BigFixed` with the precision of `point`
+ *
+ * Costs as much as a reference orbit but stores nothing, for pixels too few to be worth one.
+ */
+std::uint32_t calcMandelBigFixed(const ComplexFixed& point, unsigned int maxIterations);
+
+#endif
@@ -0,0 +1,1208 @@
+#include "render_engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "perturbation_kernel.h"
+#include "nucleus_finder.h"
+#include "double_double_kernel.h"
+#include "fixed_point_kernel.h"
+#include "tile_proof.h"
+#include "distance_estimate.h"
+
+namespace {
+
+/**
+ * Everything the tiles of one frame share, only read by the tile tasks
+ */
+struct FrameJob {
+    const ViewState& view;
+    IterationKernel kernel;
+    const ReferenceOrbit* reference; // Set for perturbation frames, the columns and rows then hold offsets to its center
+    const SeriesApproximation* series; // Set for perturbation frames
+    const BlaTable* bla; // Set for BLA frames, which do not use the series
+    FloatExp deltaScale; // Unit of the offsets of perturbation frames
+    std::uint8_t* glitchMask; // Set for perturbation frames without BLA, one flag per pixel of the buffer
+    std::vector<double> columnReal; // The real part only depends on the column ...
+    std::vector<double> rowImag;    // ... and the imaginary part only on the row
+    std::vector<double> columnRealLow; // Low parts of the coordinates of double-double frames, empty otherwise
+    std::vector<double> rowImagLow;
+    IterationBuffer& buffer;
+    const FrameRequest& request;
+    const std::atomic<std::uint64_t>& currentEpoch;
+    std::uint64_t epoch; // Epoch the frame belongs to
+    std::atomic<std::size_t> droppedTiles{0};
+    DoubleDoubleKernel doubleDoubleKernel = iterateDoubleDouble; // Used for double-double frames
+    std::vector<Fixed128> columnRealFixed{}; // Coordinates of fixed-point frames, empty otherwise
+    std::vector<Fixed128> rowImagFixed{};
+    FixedPointKernel fixedPointKernel = iterateFixed64; // Used for fixed-point frames
+    bool subdivide = false; // Mariani-Silver: tiles iterate their border and fill or split from there
+    bool prove = false; // Tiles try `proveDisk` on themselves and their quarters before iterating
+    bool distanceFill = false; // Rectangles are rendered with `renderDistanceFilled` (instead of the kernel, and of `subdivide`)
+    bool distanceFillExterior = false; // `renderDistanceFilled` also fills the disks of escaping pixels, whose counts differ
+    bool progressive = false; // Tiles are rendered with `renderTileLevel`, once per level (instead of all of the above)
+    const std::uint8_t* reusedMask = nullptr; // Set for frames that reuse pixels of the frame before, one flag per pixel that is copied already
+
+    inline bool isStale() const { return currentEpoch.load(std::memory_order_relaxed) != epoch; }
+};
+
+/**
+ * Iterates the pixels at (`xs[i]`, `ys[i]`) and writes them (and their glitch flags) to the frame
+ *
+ * All of them go to the kernel as one queue, so streaming lanes can refill across rows.
+ */
+void renderPixels(const FrameJob& job, const std::vector<int>& xs, const std::vector<int>& ys, KernelStatistics& statistics) {
+    std::size_t pixelCount = xs.size();
+    std::vector<double> startReal(pixelCount);
+    std::vector<double> startImag(pixelCount);
+    bool doubleDouble = !job.columnRealLow.empty();
+    std::vector<double> startRealLow(doubleDouble ? pixelCount : 0);
+    std::vector<double> startImagLow(doubleDouble ? pixelCount : 0);
+    bool fixedPoint = !job.columnRealFixed.empty();
+    std::vector<Fixed128> startRealFixed(fixedPoint ? pixelCount : 0);
+    std::vector<Fixed128> startImagFixed(fixedPoint ? pixelCount : 0);
+
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        std::size_t x = static_cast<std::size_t>(xs[i]);
+        std::size_t y = static_cast<std::size_t>(ys[i]);
+        startReal[i] = job.columnReal[x];
+        startImag[i] = job.rowImag[y];
+        if (doubleDouble) {
+            startRealLow[i] = job.columnRealLow[x];
+            startImagLow[i] = job.rowImagLow[y];
+        }
+        if (fixedPoint) {
+            startRealFixed[i] = job.columnRealFixed[x];
+            startImagFixed[i] = job.rowImagFixed[y];
+        }
+    }
+
+    std::vector<std::uint32_t> result(pixelCount);
+    std::vector<std::uint8_t> glitched(job.glitchMask ? pixelCount : 0);
+    if (doubleDouble)
+        job.doubleDoubleKernel(startReal.data(), startRealLow.data(), startImag.data(), startImagLow.data(), pixelCount, job.view.maxIterations,
+            result.data(), statistics);
+    else if (fixedPoint)
+        job.fixedPointKernel(startRealFixed.data(), startImagFixed.data(), pixelCount, job.view.maxIterations, result.data(), statistics);
+    else if (job.bla)
+        iterateBla(*job.reference, *job.bla, job.deltaScale, startReal.data(), startImag.data(), pixelCount, job.view.maxIterations, result.data(), statistics);
+    else if (job.reference)
+        iteratePerturbation(*job.reference, job.series, job.deltaScale, startReal.data(), startImag.data(), pixelCount, job.view.maxIterations,
+            result.data(), statistics, job.glitchMask ? glitched.data() : nullptr);
+    else
+        job.kernel(startReal.data(), startImag.data(), pixelCount, job.view.maxIterations, result.data(), statistics);
+
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        job.buffer.at(xs[i], ys[i]) = result[i];
+        if (job.glitchMask)
+            job.glitchMask[job.buffer.indexOf(xs[i], ys[i])] = glitched[i];
+    }
+}
+
+// Rectangles with less interior than this are iterated instead of split further
+constexpr int MIN_SUBDIVISION_INTERIOR = 64;
+
+/**
+ * Mariani-Silver step for a rectangle whose border pixels are already in the buffer: if they all have the same count,
+ * the interior gets that count without iterating, otherwise the rectangle is cut in two along its longer side
+ *
+ * The set and the bands of equal counts are connected, so a border of one count almost always encloses only that
+ * count. Features thinner than a pixel that cross no computed line are missed, `RenderEngine::checkSubdivision` measures that.
+ */
+void subdivideRectangle(const FrameJob& job, int x, int y, int width, int height, KernelStatistics& statistics) {
+    if (width <= 2 || height <= 2)
+        return;
+
+    std::uint32_t value = job.buffer.at(x, y);
+    bool uniform = true;
+    auto checkBorder = [&](int borderX, int borderY) {
+        uniform = uniform && job.buffer.at(borderX, borderY) == value && !(job.glitchMask && job.glitchMask[job.buffer.indexOf(borderX, borderY)]);
+    };
+    for (int i = x; i < x + width; i++) {
+        checkBorder(i, y);
+        checkBorder(i, y + height - 1);
+    }
+    for (int j = y + 1; j < y + height - 1; j++) {
+        checkBorder(x, j);
+        checkBorder(x + width - 1, j);
+    }
+
+    if (uniform) {
+        for (int j = y + 1; j < y + height - 1; j++)
+            std::fill_n(&job.buffer.at(x + 1, j), width - 2, value);
+        statistics.filledPixels += static_cast<std::uint64_t>(width - 2) * static_cast<std::uint64_t>(height - 2);
+        return;
+    }
+
+    std::vector<int> xs;
+    std::vector<int> ys;
+    if ((width - 2) * (height - 2) < MIN_SUBDIVISION_INTERIOR) {
+        for (int j = y + 1; j < y + height - 1; j++) {
+            for (int i = x + 1; i < x + width - 1; i++) {
+                xs.push_back(i);
+                ys.push_back(j);
+            }
+        }
+        renderPixels(job, xs, ys, statistics);
+        return;
+    }
+
+    // The cut line becomes the shared border of both halves
+    if (width >= height) {
+        int middle = x + width / 2;
+        for (int j = y + 1; j < y + height - 1; j++) {
+            xs.push_back(middle);
+            ys.push_back(j);
+        }
+        renderPixels(job, xs, ys, statistics);
+        subdivideRectangle(job, x, y, middle - x + 1, height, statistics);
+        subdivideRectangle(job, middle, y, x + width - middle, height, statistics);
+    }
+    else {
+        int middle = y + height / 2;
+        for (int i = x + 1; i < x + width - 1; i++) {
+            xs.push_back(i);
+            ys.push_back(middle);
+        }
+        renderPixels(job, xs, ys, statistics);
+        subdivideRectangle(job, x, y, width, middle - y + 1, statistics);
+        subdivideRectangle(job, x, middle, width, y + height - middle, statistics);
+    }
+}
+
+// Pixel spacings of the coarse-to-fine passes of `renderDistanceFilled`, the coarse passes find the large disks first
+constexpr int DISTANCE_FILL_STEPS[] = {32, 16, 8};
+
+/**
+ * Computes the pixels of the rectangle with `calcMandelDistance`, each one also fills the pixels in its disk that are still open
+ *
+ * The pixels are visited on ever finer grids, so the first ones are far apart and their disks cover most of the rest.
+ * The pixels still open after the finest grid (mostly close to the boundary) go to the kernel of the frame.
+ * Interior disks get the exact count 0, exterior ones only with `FrameJob::distanceFillExterior`.
+ */
+void renderDistanceFilled(const FrameJob& job, int x, int y, int width, int height, KernelStatistics& statistics) {
+    std::vector<std::uint8_t> done(static_cast<std::size_t>(width) * static_cast<std::size_t>(height), 0);
+    auto doneAt = [&done, width](int i, int j) -> std::uint8_t& { return done[static_cast<std::size_t>(j) * static_cast<std::size_t>(width) + static_cast<std::size_t>(i)]; };
+    double pixelSpacing = static_cast<double>(job.view.pixelSpacing());
+
+    for (int step : DISTANCE_FILL_STEPS) {
+        for (int j = 0; j < height; j += step) {
+            for (int i = 0; i < width; i += step) {
+                if (doneAt(i, j))
+                    continue;
+                double distance = 0.0;
+                std::uint32_t value = calcMandelDistance(job.columnReal[static_cast<std::size_t>(x + i)], job.rowImag[static_cast<std::size_t>(y + j)],
+                    job.view.maxIterations, distance);
+                job.buffer.at(x + i, y + j) = value;
+                doneAt(i, j) = 1;
+                std::uint64_t iterations = value == 0 ? job.view.maxIterations : value;
+                statistics.iterations += iterations;
+                statistics.laneSlots += iterations;
+
+                // Pixels are points, those strictly inside the disk are on the same side of the boundary
+                if (value != 0 && !job.distanceFillExterior)
+                    continue;
+                double radius = distance / pixelSpacing;
+                int reach = static_cast<int>(std::min(radius, static_cast<double>(std::max(width, height))));
+                for (int fillJ = std::max(0, j - reach); fillJ <= std::min(height - 1, j + reach); fillJ++) {
+                    for (int fillI = std::max(0, i - reach); fillI <= std::min(width - 1, i + reach); fillI++) {
+                        double dx = fillI - i;
+                        double dy = fillJ - j;
+                        if (doneAt(fillI, fillJ) || dx * dx + dy * dy >= radius * radius)
+                            continue;
+                        job.buffer.at(x + fillI, y + fillJ) = value;
+                        doneAt(fillI, fillJ) = 1;
+                        statistics.distancePixels++;
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<int> xs;
+    std::vector<int> ys;
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            if (!doneAt(i, j)) {
+                xs.push_back(x + i);
+                ys.push_back(y + j);
+            }
+        }
+    }
+    renderPixels(job, xs, ys, statistics);
+}
+
+/**
+ * Iterates every pixel of the rectangle, or with `FrameJob::subdivide` only its border and lets `subdivideRectangle` take over
+ */
+void renderRectangle(const FrameJob& job, int x, int y, int width, int height, KernelStatistics& statistics) {
+    if (job.distanceFill) {
+        renderDistanceFilled(job, x, y, width, height, statistics);
+        return;
+    }
+    std::vector<int> xs;
+    std::vector<int> ys;
+    for (int j = y; j < y + height; j++) {
+        bool borderRow = j == y || j == y + height - 1;
+        for (int i = x; i < x + width; i++) {
+            if (!job.subdivide || borderRow || i == x || i == x + width - 1) {
+                xs.push_back(i);
+                ys.push_back(j);
+            }
+        }
+    }
+    renderPixels(job, xs, ys, statistics);
+    if (job.subdivide)
+        subdivideRectangle(job, x, y, width, height, statistics);
+}
+
+// Rectangles up to this edge length are not quartered any further when their proof fails
+constexpr int MIN_PROOF_SIZE = 8;
+
+/**
+ * Fills the rectangle if `proveDisk` shows that all its pixels have the same count, otherwise tries its quarters
+ * and renders what stays unproven with `renderRectangle`
+ */
+void renderProvenRectangle(const FrameJob& job, int x, int y, int width, int height, KernelStatistics& statistics) {
+    double realFirst = job.columnReal[static_cast<std::size_t>(x)];
+    double realLast = job.columnReal[static_cast<std::size_t>(x + width - 1)];
+    double imagFirst = job.rowImag[static_cast<std::size_t>(y)];
+    double imagLast = job.rowImag[static_cast<std::size_t>(y + height - 1)];
+    double radius = std::hypot(0.5 * (realLast - realFirst), 0.5 * (imagLast - imagFirst));
+    if (!job.columnRealLow.empty()) {
+        // Double-double pixels lie up to half an ulp of their high parts away from them
+        radius += std::numeric_limits<double>::epsilon() * std::max({std::fabs(realFirst), std::fabs(realLast), std::fabs(imagFirst), std::fabs(imagLast)});
+    }
+
+    std::uint32_t escapeIteration = 0;
+    TileProof proof = proveDisk(0.5 * (realFirst + realLast), 0.5 * (imagFirst + imagLast), radius, job.view.maxIterations, escapeIteration);
+    if (proof != TileProof::None) {
+        std::uint32_t value = proof == TileProof::Escaped ? escapeIteration : 0;
+        for (int j = y; j < y + height; j++)
+            std::fill_n(&job.buffer.at(x, j), width, value);
+        statistics.provenPixels += static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+        return;
+    }
+
+    if (width <= MIN_PROOF_SIZE && height <= MIN_PROOF_SIZE) {
+        renderRectangle(job, x, y, width, height, statistics);
+        return;
+    }
+    int leftWidth = (width + 1) / 2;
+    int topHeight = (height + 1) / 2;
+    renderProvenRectangle(job, x, y, leftWidth, topHeight, statistics);
+    if (width > leftWidth)
+        renderProvenRectangle(job, x + leftWidth, y, width - leftWidth, topHeight, statistics);
+    if (height > topHeight) {
+        renderProvenRectangle(job, x, y + topHeight, leftWidth, height - topHeight, statistics);
+        if (width > leftWidth)
+            renderProvenRectangle(job, x + leftWidth, y + topHeight, width - leftWidth, height - topHeight, statistics);
+    }
+}
+
+/**
+ * Renders a rectangle of a tile, proving it (or its quarters) uniform first with `FrameJob::prove`
+ */
+void renderTileRectangle(const FrameJob& job, int x, int y, int width, int height, KernelStatistics& statistics) {
+    if (job.prove)
+        renderProvenRectangle(job, x, y, width, height, statistics);
+    else
+        renderRectangle(job, x, y, width, height, statistics);
+}
+
+/**
+ * Renders one tile, or only its pixels that are not copied from the frame before
+ */
+void renderTile(const FrameJob& job, TileReport& report, KernelStatistics& statistics) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::uint64_t iterationsBefore = statistics.iterations;
+
+    std::vector<int> xs;
+    std::vector<int> ys;
+    if (job.reusedMask) {
+        for (int y = report.y; y < report.y + report.height; y++) {
+            for (int x = report.x; x < report.x + report.width; x++) {
+                if (!job.reusedMask[job.buffer.indexOf(x, y)]) {
+                    xs.push_back(x);
+                    ys.push_back(y);
+                }
+            }
+        }
+    }
+    // Tiles that reuse nothing (like those a pan uncovered) can still be proven or subdivided
+    if (!job.reusedMask || xs.size() == static_cast<std::size_t>(report.width) * static_cast<std::size_t>(report.height))
+        renderTileRectangle(job, report.x, report.y, report.width, report.height, statistics);
+    else if (!xs.empty())
+        renderPixels(job, xs, ys, statistics);
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    report.milliseconds = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    report.iterations = statistics.iterations - iterationsBefore;
+}
+
+// Grid spacing of the first level of progressive frames (1/16 of the pixels), every further level halves it
+constexpr int PROGRESSIVE_FIRST_STEP = 4;
+
+/**
+ * Renders the pixels of one level of a progressive frame in one tile: those on the grid of spacing `step` that are not
+ * on the grid of the level before
+ *
+ * A pixel whose neighbours on the coarser grid (up to four, `step` away) all have the same count gets that count
+ * without iterating, like in Mariani-Silver this can miss features thinner than the coarser grid. Until the next
+ * level every pixel of the level also fills its `step` x `step` block, so each level can be shown on its own.
+ */
+void renderTileLevel(const FrameJob& job, TileReport& report, KernelStatistics& statistics, int step) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::uint64_t iterationsBefore = statistics.iterations;
+    int coarseStep = 2 * step;
+    bool firstLevel = step == PROGRESSIVE_FIRST_STEP;
+
+    // Neighbours on the coarser grid: the pixel itself along an axis that is on it, otherwise one to each side
+    auto neighboursAgree = [&job, step, coarseStep](int x, int y, std::uint32_t& value) {
+        int xs[2] = {x % coarseStep == 0 ? x : x - step, x + step};
+        int ys[2] = {y % coarseStep == 0 ? y : y - step, y + step};
+        int xCount = x % coarseStep == 0 || x + step >= job.buffer.width ? 1 : 2;
+        int yCount = y % coarseStep == 0 || y + step >= job.buffer.height ? 1 : 2;
+        value = job.buffer.at(xs[0], ys[0]);
+        for (int j = 0; j < yCount; j++) {
+            for (int i = 0; i < xCount; i++) {
+                if (job.buffer.at(xs[i], ys[j]) != value || (job.glitchMask && job.glitchMask[job.buffer.indexOf(xs[i], ys[j])]))
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    // The tiles start on the grid of every level, `render` makes their size a multiple of `PROGRESSIVE_FIRST_STEP`
+    std::vector<int> xs;
+    std::vector<int> ys;
+    for (int y = report.y; y < report.y + report.height; y += step) {
+        for (int x = report.x; x < report.x + report.width; x += step) {
+            if (firstLevel) {
+                xs.push_back(x);
+                ys.push_back(y);
+                continue;
+            }
+            if (x % coarseStep == 0 && y % coarseStep == 0)
+                continue; // Done on the level before
+            std::uint32_t value;
+            if (neighboursAgree(x, y, value)) {
+                job.buffer.at(x, y) = value;
+                statistics.guessedPixels++;
+                continue;
+            }
+            xs.push_back(x);
+            ys.push_back(y);
+        }
+    }
+    renderPixels(job, xs, ys, statistics);
+
+    // Blocks start at their pixel and stay in the tile, other tiles own the rest
+    if (step > 1) {
+        for (int y = report.y; y < report.y + report.height; y += step) {
+            for (int x = report.x; x < report.x + report.width; x += step) {
+                std::uint32_t value = job.buffer.at(x, y);
+                int blockWidth = std::min(step, report.x + report.width - x);
+                // The pixel itself is left alone, on the coarser grid other tiles may be reading it
+                if (blockWidth > 1)
+                    std::fill_n(&job.buffer.at(x + 1, y), blockWidth - 1, value);
+                for (int blockY = y + 1; blockY < std::min(y + step, report.y + report.height); blockY++)
+                    std::fill_n(&job.buffer.at(x, blockY), blockWidth, value);
+            }
+        }
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    report.milliseconds += std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    report.iterations += statistics.iterations - iterationsBefore;
+}
+
+// Frames only reuse frames up to this many powers of two of zoom away, farther ones share too few points
+constexpr int MAX_REUSE_SCALE = 4;
+
+/**
+ * @return Whether both settings give the same counts for the same points with the same algorithm, so cached tiles stay valid
+ */
+bool giveSameCounts(const RenderSettings& first, const RenderSettings& second) {
+    return first.isa == second.isa && first.kernelMode == second.kernelMode && first.seriesTerms == second.seriesTerms
+        && first.referenceMemoryLimit == second.referenceMemoryLimit && first.nucleusReference == second.nucleusReference;
+}
+
+std::int64_t floorDivide(std::int64_t value, std::int64_t divisor) {
+    std::int64_t quotient = value / divisor;
+    return quotient * divisor > value ? quotient - 1 : quotient;
+}
+
+TileKey makeTileKey(const ViewState& view, RenderAlgorithm algorithm, long double zoomScale, std::int64_t tileX, std::int64_t tileY) {
+    return {static_cast<int>(algorithm), view.realPartStart, view.imagPartStart, view.latticeFractionLimbs(), view.width, view.height, zoomScale, tileX, tileY};
+}
+
+// Bounds of the glitch correction, the frame has to finish even where extra references keep glitching
+constexpr unsigned int MAX_GLITCH_PASSES = 8;
+constexpr std::size_t MAX_GLITCH_REFERENCES_PER_PASS = 64;
+// Groups of up to this many pixels are iterated in `BigFixed` one by one, which costs each of them about one reference orbit
+constexpr std::size_t MAX_DIRECT_GLITCH_PIXELS = 2;
+
+/**
+ * Connected glitched pixels, which get one extra reference orbit at `referenceX`, `referenceY`
+ */
+struct GlitchGroup {
+    std::vector<std::size_t> pixels; // Buffer indices
+    int referenceX = 0;
+    int referenceY = 0;
+};
+
+/**
+ * Splits the flagged pixels of `mask` into 4-connected groups, largest first
+ *
+ * The reference of a group is the member nearest to the centroid, the blobs are roughly round around the point
+ * where the full orbit passes closest to 0, which is where a reference works for the whole blob.
+ */
+std::vector<GlitchGroup> findGlitchGroups(const std::uint8_t* mask, int width, int height) {
+    std::vector<GlitchGroup> groups;
+    std::vector<std::uint8_t> visited(static_cast<std::size_t>(width) * static_cast<std::size_t>(height), 0);
+    std::vector<std::size_t> pending;
+    for (std::size_t start = 0; start < visited.size(); start++) {
+        if (!mask[start] || visited[start])
+            continue;
+
+        GlitchGroup group;
+        visited[start] = 1;
+        pending.push_back(start);
+        while (!pending.empty()) {
+            std::size_t index = pending.back();
+            pending.pop_back();
+            group.pixels.push_back(index);
+            int x = static_cast<int>(index % static_cast<std::size_t>(width));
+            int y = static_cast<int>(index / static_cast<std::size_t>(width));
+            auto visit = [&](int neighbourX, int neighbourY) {
+                if (neighbourX < 0 || neighbourY < 0 || neighbourX >= width || neighbourY >= height)
+                    return;
+                std::size_t neighbour = static_cast<std::size_t>(neighbourY) * static_cast<std::size_t>(width) + static_cast<std::size_t>(neighbourX);
+                if (mask[neighbour] && !visited[neighbour]) {
+                    visited[neighbour] = 1;
+                    pending.push_back(neighbour);
+                }
+            };
+            visit(x - 1, y);
+            visit(x + 1, y);
+            visit(x, y - 1);
+            visit(x, y + 1);
+        }
+
+        double sumX = 0.0;
+        double sumY = 0.0;
+        for (std::size_t index : group.pixels) {
+            sumX += static_cast<double>(index % static_cast<std::size_t>(width));
+            sumY += static_cast<double>(index / static_cast<std::size_t>(width));
+        }
+        double centroidX = sumX / static_cast<double>(group.pixels.size());
+        double centroidY = sumY / static_cast<double>(group.pixels.size());
+        double bestDistance = -1.0;
+        for (std::size_t index : group.pixels) {
+            double dx = static_cast<double>(index % static_cast<std::size_t>(width)) - centroidX;
+            double dy = static_cast<double>(index / static_cast<std::size_t>(width)) - centroidY;
+            if (bestDistance < 0.0 || dx * dx + dy * dy < bestDistance) {
+                bestDistance = dx * dx + dy * dy;
+                group.referenceX = static_cast<int>(index % static_cast<std::size_t>(width));
+                group.referenceY = static_cast<int>(index / static_cast<std::size_t>(width));
+            }
+        }
+        groups.push_back(std::move(group));
+    }
+    std::stable_sort(groups.begin(), groups.end(), [](const GlitchGroup& a, const GlitchGroup& b) { return a.pixels.size() > b.pixels.size(); });
+    return groups;
+}
+
+/**
+ * Reports the corrected pixels of `group` as the tile of their bounding box
+ */
+void reportGlitchGroup(const FrameJob& job, const GlitchGroup& group) {
+    if (!job.request.onTileDone || job.isStale())
+        return;
+    int minX = job.view.width;
+    int minY = job.view.height;
+    int maxX = 0;
+    int maxY = 0;
+    for (std::size_t index : group.pixels) {
+        int x = static_cast<int>(index % static_cast<std::size_t>(job.view.width));
+        int y = static_cast<int>(index / static_cast<std::size_t>(job.view.width));
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+    TileReport bounds;
+    bounds.x = minX;
+    bounds.y = minY;
+    bounds.width = maxX - minX + 1;
+    bounds.height = maxY - minY + 1;
+    job.request.onTileDone(bounds);
+}
+
+/**
+ * Renders the pixels of `group` again against a reference orbit of their own, pixels that still glitch stay flagged.
+ * Groups of at most `MAX_DIRECT_GLITCH_PIXELS` are iterated exactly in `BigFixed` instead, they need no orbit.
+ */
+void renderGlitchGroup(const FrameJob& job, const GlitchGroup& group, std::size_t referenceMemoryLimit, KernelStatistics& statistics) {
+    const ViewState& view = job.view;
+    int fractionLimbs = view.requiredFractionLimbs();
+    ComplexFixed center = view.center();
+    if (group.pixels.size() <= MAX_DIRECT_GLITCH_PIXELS) {
+        for (std::size_t index : group.pixels) {
+            ComplexNum offset = view.offsetFromCenter(static_cast<int>(index % static_cast<std::size_t>(view.width)),
+                static_cast<int>(index / static_cast<std::size_t>(view.width)));
+            std::uint32_t count = calcMandelBigFixed({center.real + BigFixed{offset.first, fractionLimbs}, center.imag + BigFixed{offset.second, fractionLimbs}},
+                view.maxIterations);
+            job.buffer.iterations[index] = count;
+            job.glitchMask[index] = 0;
+            statistics.iterations += count != 0 ? count : view.maxIterations;
+        }
+        reportGlitchGroup(job, group);
+        return;
+    }
+
+    ComplexNum referenceOffset = view.offsetFromCenter(group.referenceX, group.referenceY);
+    ReferenceOrbit reference;
+    reference.compute({center.real + BigFixed{referenceOffset.first, fractionLimbs}, center.imag + BigFixed{referenceOffset.second, fractionLimbs}},
+        view.maxIterations, referenceMemoryLimit);
+
+    std::size_t pixelCount = group.pixels.size();
+    std::vector<double> deltaReal(pixelCount);
+    std::vector<double> deltaImag(pixelCount);
+    std::vector<std::uint32_t> result(pixelCount);
+    std::vector<std::uint8_t> glitched(pixelCount);
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        ComplexNum offset = view.offsetFromCenter(static_cast<int>(group.pixels[i] % static_cast<std::size_t>(view.width)),
+            static_cast<int>(group.pixels[i] / static_cast<std::size_t>(view.width)));
+        deltaReal[i] = static_cast<double>(std::ldexp(offset.first - referenceOffset.first, -job.deltaScale.exponent));
+        deltaImag[i] = static_cast<double>(std::ldexp(offset.second - referenceOffset.second, -job.deltaScale.exponent));
+    }
+
+    iteratePerturbation(reference, nullptr, job.deltaScale, deltaReal.data(), deltaImag.data(), pixelCount, view.maxIterations, result.data(),
+        statistics, glitched.data());
+
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        job.buffer.iterations[group.pixels[i]] = result[i];
+        job.glitchMask[group.pixels[i]] = glitched[i];
+    }
+    reportGlitchGroup(job, group);
+}
+
+} // namespace
+
+const char* renderAlgorithmName(RenderAlgorithm algorithm) {
+    switch (algorithm) {
+        case RenderAlgorithm::Auto:
+            return "auto";
+        case RenderAlgorithm::Direct:
+            return "direct";
+        case RenderAlgorithm::Perturbation:
+            return "perturbation";
+        case RenderAlgorithm::Bla:
+            return "bla";
+        case RenderAlgorithm::DoubleDouble:
+            return "double-double";
+        case RenderAlgorithm::FixedPoint:
+            return "fixed-point";
+    }
+    return "unknown";
+}
+
+ThreadPool& RenderEngine::getThreadPool() {
+    unsigned int threadCount = settings.threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : settings.threadCount;
+    if (!threadPool || threadPool->getThreadCount() != threadCount)
+        threadPool = std::make_unique<ThreadPool>(threadCount);
+    return *threadPool;
+}
+
+IterationBuffer RenderEngine::render(const ViewState& view) {
+    IterationBuffer buffer{view.width, view.height};
+    render(view, buffer, {});
+    return buffer;
+}
+
+void RenderEngine::render(const ViewState& view, IterationBuffer& buffer, const FrameRequest& request) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    KernelIsa isa = isIsaSupported(settings.isa) ? settings.isa : KernelIsa::Scalar;
+    RenderAlgorithm algorithm = resolveAlgorithm(view);
+    bool perturbation = algorithm == RenderAlgorithm::Perturbation || algorithm == RenderAlgorithm::Bla;
+    FrameJob job{view, selectKernel(isa, settings.kernelMode), nullptr, nullptr, nullptr, {}, nullptr, {}, {}, {}, {}, buffer, request, viewEpoch, viewEpoch.load()};
+
+    job.subdivide = settings.rectangleSubdivision;
+    // The disks are iterated in double around absolute coordinates, which only direct and double-double frames have
+    job.prove = settings.provenTiles && (algorithm == RenderAlgorithm::Direct || algorithm == RenderAlgorithm::DoubleDouble);
+    job.distanceFill = settings.distanceFill && algorithm == RenderAlgorithm::Direct;
+    job.distanceFillExterior = settings.membershipOnly;
+    job.progressive = settings.progressiveRefinement;
+
+    // Points the frame before already computed are copied, they have bit-identical coordinates on the shared lattice
+    RenderAlgorithm resolvedAlgorithm = algorithm;
+    std::size_t reusedPixels = 0;
+    std::vector<int> previousColumns;
+    std::vector<int> previousRows;
+    std::vector<std::uint8_t> reusedMask;
+    if (canReusePixels(view, algorithm, previousColumns, previousRows)) {
+        // Counts up to the lower limit are the same under both limits, only pixels that did not escape may escape later
+        bool higherLimit = view.maxIterations > previousFrameView.maxIterations;
+        reusedMask.assign(static_cast<std::size_t>(view.width) * static_cast<std::size_t>(view.height), 0);
+        for (int y = 0; y < view.height; y++) {
+            int previousY = previousRows[static_cast<std::size_t>(y)];
+            if (previousY < 0)
+                continue;
+            for (int x = 0; x < view.width; x++) {
+                int previousX = previousColumns[static_cast<std::size_t>(x)];
+                if (previousX < 0)
+                    continue;
+                std::uint32_t count = previousFrame.at(previousX, previousY);
+                if (count == 0 && higherLimit)
+                    continue;
+                buffer.at(x, y) = count > view.maxIterations ? 0 : count;
+                reusedMask[buffer.indexOf(x, y)] = 1;
+                reusedPixels++;
+            }
+        }
+    }
+
+    // Points of frames further back come from the tile cache. Only counts that depend on nothing but the point go in, so
+    // not those of perturbation frames (their reference orbit, series and glitch references depend on the view) or of the
+    // options that guess pixels
+    bool tileCacheEnabled = settings.tileCacheMemory > 0 && !perturbation && !settings.rectangleSubdivision && !settings.distanceFill
+        && !settings.progressiveRefinement;
+    if (!giveSameCounts(settings, tileCacheSettings))
+        tileCache.clear();
+    tileCacheSettings = settings;
+    tileCache.setMemoryBudget(settings.tileCacheMemory);
+    std::size_t cachedPixels = tileCacheEnabled ? fillFromTileCache(view, resolvedAlgorithm, buffer, reusedMask) : 0;
+    if (reusedPixels + cachedPixels > 0)
+        job.reusedMask = reusedMask.data();
+
+    double referenceSeconds = 0.0;
+    bool referenceReused = false;
+    ComplexNum referenceShift{0.0L, 0.0L}; // Reference center to the lattice origin of the view
+    std::vector<std::uint8_t> glitchMask;
+    if (perturbation) {
+        ComplexFixed viewCenter = view.center();
+        ComplexFixed origin = view.latticeOrigin();
+        ComplexNum corner = view.offsetFromLatticeOrigin(0, 0);
+        ComplexNum oppositeCorner = view.offsetFromLatticeOrigin(view.width - 1, view.height - 1);
+        long double viewRadius = view.radius();
+
+        // The reference orbit is the expensive part of a deep frame, pans and zooms keep it while it still serves the new view
+        ComplexNum centerShift{(viewCenter.real - referenceOrbit.getCenter().real).toLongDouble(), (viewCenter.imag - referenceOrbit.getCenter().imag).toLongDouble()};
+        referenceReused = canReuseReference(view, centerShift, viewRadius);
+        ComplexFixed referenceCenter = referenceOrbit.getCenter();
+        if (!referenceReused) {
+            // The orbit of a nucleus only needs one period, no matter how many iterations the pixels take
+            Nucleus nucleus;
+            if (settings.nucleusReference && findNucleus(viewCenter, viewRadius, view.maxIterations, nucleus)) {
+                referenceOrbit.computePeriodic(nucleus.center, nucleus.period, settings.referenceMemoryLimit);
+                referenceCenter = nucleus.center;
+            }
+            else {
+                referenceOrbit.compute(viewCenter, view.maxIterations, settings.referenceMemoryLimit);
+                referenceCenter = viewCenter;
+            }
+            referenceFromNucleusSearch = settings.nucleusReference;
+        }
+        // Offsets from the lattice origin are the same for a point in every view on the lattice, which keeps reused pixels consistent
+        referenceShift = {(origin.real - referenceCenter.real).toLongDouble(), (origin.imag - referenceCenter.imag).toLongDouble()};
+        job.reference = &referenceOrbit;
+        referenceSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        // Offsets to the reference are the shift of the lattice origin plus the offsets to it
+        long double radius = std::hypot(
+            std::max(std::fabs(referenceShift.first + corner.first), std::fabs(referenceShift.first + oppositeCorner.first)),
+            std::max(std::fabs(referenceShift.second + corner.second), std::fabs(referenceShift.second + oppositeCorner.second)));
+        // The offsets are stored in units of a power of two near the radius, which keeps them in range of double at any depth
+        std::int32_t scaleExponent = radius > 0.0L ? std::ilogb(radius) : 0;
+        job.deltaScale = FloatExp{1.0, scaleExponent};
+        double scaledRadius = static_cast<double>(std::ldexp(radius, -scaleExponent));
+        // BLA steps jump around in the orbit, which a compressed orbit cannot do
+        if (referenceOrbit.isCompressed())
+            algorithm = RenderAlgorithm::Perturbation;
+        if (algorithm == RenderAlgorithm::Bla) {
+            blaTable.build(referenceOrbit, (job.deltaScale * scaledRadius).toDouble());
+            job.bla = &blaTable;
+        }
+        else {
+            seriesApproximation.compute(referenceOrbit, job.deltaScale, scaledRadius, settings.seriesTerms, view.maxIterations);
+            job.series = &seriesApproximation;
+            // BLA frames rebase whenever the delta outgrows the full value, so only plain perturbation glitches
+            glitchMask.assign(static_cast<std::size_t>(view.width) * static_cast<std::size_t>(view.height), 0);
+            job.glitchMask = glitchMask.data();
+        }
+    }
+
+    // Perturbation frames only need the offsets to the reference, which keep their precision at any depth
+    auto scaledOffset = [&job](long double offset) { return static_cast<double>(std::ldexp(offset, -job.deltaScale.exponent)); };
+    job.columnReal.resize(static_cast<std::size_t>(view.width));
+    for (int x = 0; x < view.width; x++) {
+        job.columnReal[static_cast<std::size_t>(x)] = static_cast<double>(perturbation
+            ? scaledOffset(referenceShift.first + view.offsetFromLatticeOrigin(x, 0).first) : view.pointAt(x, 0).first);
+    }
+    job.rowImag.resize(static_cast<std::size_t>(view.height));
+    for (int y = 0; y < view.height; y++) {
+        job.rowImag[static_cast<std::size_t>(y)] = static_cast<double>(perturbation
+            ? scaledOffset(referenceShift.second + view.offsetFromLatticeOrigin(0, y).second) : view.pointAt(0, y).second);
+    }
+
+    // Double-double coordinates are the lattice origin plus the offsets, long double would round them to 64 bits
+    if (algorithm == RenderAlgorithm::DoubleDouble) {
+        job.doubleDoubleKernel = selectDoubleDoubleKernel(isa);
+        ComplexFixed origin = view.latticeOrigin();
+        DoubleDouble originReal = DoubleDouble::fromBigFixed(origin.real);
+        DoubleDouble originImag = DoubleDouble::fromBigFixed(origin.imag);
+        job.columnRealLow.resize(static_cast<std::size_t>(view.width));
+        for (int x = 0; x < view.width; x++) {
+            DoubleDouble real = originReal + DoubleDouble::fromLongDouble(view.offsetFromLatticeOrigin(x, 0).first);
+            job.columnReal[static_cast<std::size_t>(x)] = real.high;
+            job.columnRealLow[static_cast<std::size_t>(x)] = real.low;
+        }
+        job.rowImagLow.resize(static_cast<std::size_t>(view.height));
+        for (int y = 0; y < view.height; y++) {
+            DoubleDouble imag = originImag + DoubleDouble::fromLongDouble(view.offsetFromLatticeOrigin(0, y).second);
+            job.rowImag[static_cast<std::size_t>(y)] = imag.high;
+            job.rowImagLow[static_cast<std::size_t>(y)] = imag.low;
+        }
+    }
+
+    // Fixed-point coordinates too, the 64 bit kernel only reads the high words. Its 56 fraction bits are only 3 more than
+    // double has at |Z| = 1, so it only pays off in the few zoom levels where those bits resolve the pixels (2^11 ulps
+    // per pixel, like `ViewState::isPrecisionSufficient`) and double does not. Shallower views gain nothing over direct
+    // from it, fixed-point frames are asked for their precision, so they get 128 bits like the deeper ones
+    unsigned int fixedPointBits = 0;
+    if (algorithm == RenderAlgorithm::FixedPoint) {
+        bool beatsDouble = !view.isDoublePrecisionSufficient() && view.pixelSpacing() >= std::ldexp(1.0L, 11 - Fixed128::HIGH_FRACTION_BITS);
+        fixedPointBits = beatsDouble ? 64 : 128;
+        job.fixedPointKernel = fixedPointBits == 64 ? iterateFixed64 : iterateFixed128;
+        ComplexFixed origin = view.latticeOrigin();
+        int fractionLimbs = origin.real.getFractionLimbs();
+        job.columnRealFixed.resize(static_cast<std::size_t>(view.width));
+        for (int x = 0; x < view.width; x++) {
+            BigFixed real = origin.real + BigFixed{view.offsetFromLatticeOrigin(x, 0).first, fractionLimbs};
+            job.columnRealFixed[static_cast<std::size_t>(x)] = Fixed128::fromBigFixed(real);
+        }
+        job.rowImagFixed.resize(static_cast<std::size_t>(view.height));
+        for (int y = 0; y < view.height; y++) {
+            BigFixed imag = origin.imag + BigFixed{view.offsetFromLatticeOrigin(0, y).second, fractionLimbs};
+            job.rowImagFixed[static_cast<std::size_t>(y)] = Fixed128::fromBigFixed(imag);
+        }
+    }
+
+    int tileSize = std::max(1, settings.tileSize);
+    // Progressive tiles start on the grid of the first level, so every pixel of theirs has a grid pixel to fill it from
+    if (job.progressive)
+        tileSize = (tileSize + PROGRESSIVE_FIRST_STEP - 1) / PROGRESSIVE_FIRST_STEP * PROGRESSIVE_FIRST_STEP;
+    lastTileReports.clear();
+    for (int y = 0; y < view.height; y += tileSize) {
+        for (int x = 0; x < view.width; x += tileSize) {
+            TileReport report;
+            report.x = x;
+            report.y = y;
+            report.width = std::min(tileSize, view.width - x);
+            report.height = std::min(tileSize, view.height - y);
+            lastTileReports.push_back(report);
+        }
+    }
+
+    // Center-out: the tiles are submitted farthest first, so the newest (= nearest) tile sits at the back
+    // of every deque, where its owner takes it from. Thieves take the far tiles from the front.
+    int focusX = request.focusX >= 0 ? request.focusX : view.width / 2;
+    int focusY = request.focusY >= 0 ? request.focusY : view.height / 2;
+    auto distanceToFocus = [focusX, focusY](const TileReport& tile) {
+        long long dx = std::clamp(focusX, tile.x, tile.x + tile.width - 1) - focusX;
+        long long dy = std::clamp(focusY, tile.y, tile.y + tile.height - 1) - focusY;
+        return dx * dx + dy * dy;
+    };
+    std::vector<std::size_t> order(lastTileReports.size());
+    for (std::size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return distanceToFocus(lastTileReports[a]) > distanceToFocus(lastTileReports[b]);
+    });
+
+    // Tile costs differ by orders of magnitude, the pool balances them by work stealing
+    ThreadPool& pool = getThreadPool();
+    std::uint64_t stealsBefore = pool.getStealCount();
+    std::vector<KernelStatistics> tileStatistics(lastTileReports.size());
+    // Progressive frames go over all tiles once per level, coarsest first, so the whole view shows up early
+    std::vector<int> levelSteps = job.progressive ? std::vector<int>{PROGRESSIVE_FIRST_STEP, PROGRESSIVE_FIRST_STEP / 2, 1} : std::vector<int>{1};
+    for (int step : levelSteps) {
+        for (std::size_t i : order) {
+            pool.submit([&job, &pool, &report = lastTileReports[i], &statistics = tileStatistics[i], step] {
+                if (job.isStale()) {
+                    if (step == 1) // Only the last level makes a tile complete
+                        job.droppedTiles.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                report.worker = pool.currentWorker();
+                if (job.progressive)
+                    renderTileLevel(job, report, statistics, step);
+                else
+                    renderTile(job, report, statistics);
+                if (job.request.onTileDone && !job.isStale())
+                    job.request.onTileDone(report);
+            });
+        }
+        pool.wait();
+    }
+
+    // Glitched pixels get extra references, one per group, until none are left or the passes run out
+    std::size_t glitchedPixels = static_cast<std::size_t>(std::count(glitchMask.begin(), glitchMask.end(), std::uint8_t{1}));
+    unsigned int glitchPasses = 0;
+    std::size_t glitchReferences = 0;
+    while (job.glitchMask && !job.isStale() && glitchPasses < MAX_GLITCH_PASSES) {
+        std::vector<GlitchGroup> groups = findGlitchGroups(job.glitchMask, view.width, view.height);
+        if (groups.empty())
+            break;
+        if (groups.size() > MAX_GLITCH_REFERENCES_PER_PASS)
+            groups.resize(MAX_GLITCH_REFERENCES_PER_PASS);
+
+        // The extra references share one memory limit, split between the orbits the workers compute at the same time
+        std::size_t referenceGroups = static_cast<std::size_t>(std::count_if(groups.begin(), groups.end(),
+            [](const GlitchGroup& group) { return group.pixels.size() > MAX_DIRECT_GLITCH_PIXELS; }));
+        std::size_t referencesInFlight = std::clamp<std::size_t>(referenceGroups, 1, pool.getThreadCount());
+        std::size_t memoryLimit = settings.referenceMemoryLimit / referencesInFlight;
+
+        glitchPasses++;
+        glitchReferences += referenceGroups;
+        std::size_t firstStatistics = tileStatistics.size();
+        tileStatistics.resize(firstStatistics + groups.size());
+        for (std::size_t i = 0; i < groups.size(); i++) {
+            pool.submit([&job, &group = groups[i], &statistics = tileStatistics[firstStatistics + i], memoryLimit] {
+                if (!job.isStale())
+                    renderGlitchGroup(job, group, memoryLimit, statistics);
+            });
+        }
+        pool.wait();
+    }
+
+    KernelStatistics kernelStatistics;
+    for (const KernelStatistics& statistics : tileStatistics) {
+        kernelStatistics.iterations += statistics.iterations;
+        kernelStatistics.laneSlots += statistics.laneSlots;
+        kernelStatistics.bulbPixels += statistics.bulbPixels;
+        kernelStatistics.periodicPixels += statistics.periodicPixels;
+        kernelStatistics.filledPixels += statistics.filledPixels;
+        kernelStatistics.provenPixels += statistics.provenPixels;
+        kernelStatistics.distancePixels += statistics.distancePixels;
+        kernelStatistics.guessedPixels += statistics.guessedPixels;
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    // The perturbation and fixed-point kernels are scalar, the double-double kernel has a batched AVX2 variant
+    if (perturbation || algorithm == RenderAlgorithm::FixedPoint)
+        lastStatistics.isa = KernelIsa::Scalar;
+    else if (algorithm == RenderAlgorithm::DoubleDouble)
+        lastStatistics.isa = job.doubleDoubleKernel == iterateDoubleDouble ? KernelIsa::Scalar : KernelIsa::Avx2;
+    else
+        lastStatistics.isa = isa;
+    bool batched = perturbation || algorithm == RenderAlgorithm::DoubleDouble || algorithm == RenderAlgorithm::FixedPoint;
+    lastStatistics.kernelMode = batched ? KernelMode::Batched : settings.kernelMode;
+    lastStatistics.algorithm = algorithm;
+    lastStatistics.fixedPointBits = fixedPointBits;
+    lastStatistics.referenceIterations = perturbation ? referenceOrbit.size() - 1 : 0;
+    lastStatistics.referenceSeconds = referenceSeconds;
+    lastStatistics.referenceReused = referenceReused;
+    lastStatistics.referenceBytes = perturbation ? referenceOrbit.getBytes() : 0;
+    lastStatistics.referenceCompressed = perturbation && referenceOrbit.isCompressed();
+    lastStatistics.referencePeriod = perturbation ? referenceOrbit.getPeriod() : 0;
+    lastStatistics.seriesSkippedIterations = job.series ? seriesApproximation.getSkipIterations() : 0;
+    lastStatistics.seriesErrorBound = job.series ? seriesApproximation.getErrorBound() : 0.0;
+    lastStatistics.blaLevelBytes = job.bla ? blaTable.getLevelBytes() : std::vector<std::size_t>{};
+    lastStatistics.rescaledDeltas = perturbation && job.deltaScale.exponent < RESCALED_DELTA_EXPONENT;
+    lastStatistics.glitchedPixels = glitchedPixels;
+    lastStatistics.glitchPasses = glitchPasses;
+    lastStatistics.glitchReferences = glitchReferences;
+    lastStatistics.remainingGlitches = static_cast<std::size_t>(std::count(glitchMask.begin(), glitchMask.end(), std::uint8_t{1}));
+    lastStatistics.iterations = kernelStatistics.iterations;
+    lastStatistics.laneUtilization = kernelStatistics.laneUtilization();
+    lastStatistics.bulbPixels = kernelStatistics.bulbPixels;
+    lastStatistics.periodicPixels = kernelStatistics.periodicPixels;
+    lastStatistics.filledPixels = kernelStatistics.filledPixels;
+    lastStatistics.provenPixels = kernelStatistics.provenPixels;
+    lastStatistics.distancePixels = kernelStatistics.distancePixels;
+    lastStatistics.guessedPixels = kernelStatistics.guessedPixels;
+    lastStatistics.reusedPixels = reusedPixels;
+    lastStatistics.cachedPixels = cachedPixels;
+    lastStatistics.threadCount = pool.getThreadCount();
+    lastStatistics.tileCount = lastTileReports.size();
+    lastStatistics.droppedTiles = job.droppedTiles.load();
+    lastStatistics.steals = pool.getStealCount() - stealsBefore;
+    lastStatistics.seconds = std::chrono::duration<double>(endTime - startTime).count();
+
+    // Only complete frames can be reused, after a dropped one the next view is compared to the last complete frame
+    if (!settings.reusePixels)
+        previousFrameAlgorithm = RenderAlgorithm::Auto;
+    else if (job.droppedTiles.load() == 0 && !job.isStale()) {
+        previousFrame = buffer;
+        previousFrameView = view;
+        previousFrameSettings = settings;
+        previousFrameAlgorithm = resolvedAlgorithm;
+    }
+    if (tileCacheEnabled && job.droppedTiles.load() == 0 && !job.isStale())
+        storeInTileCache(view, resolvedAlgorithm, buffer, glitchMask);
+    lastStatistics.tileCache = tileCache.getStatistics();
+}
+
+RgbImage RenderEngine::renderImage(const ViewState& view, FlowColorType colorType) {
+    return colorize(render(view), colorType);
+}
+
+bool RenderEngine::canReuseReference(const ViewState& view, const ComplexNum& shift, long double viewRadius) const {
+    if (referenceOrbit.size() < 2 || referenceFromNucleusSearch != settings.nucleusReference)
+        return false;
+    // The orbit has to be as precise as a fresh one and at least as long, unless it escaped anyway or repeats
+    if (referenceOrbit.getCenter().real.getFractionLimbs() < view.requiredFractionLimbs())
+        return false;
+    if (!referenceOrbit.hasEscaped() && !referenceOrbit.isTruncated() && referenceOrbit.getPeriod() == 0 && referenceOrbit.size() - 1 < view.maxIterations)
+        return false;
+    // The reference has to stay among the pixels of the frame, far away references glitch and let the series skip less
+    return std::hypot(shift.first, shift.second) <= viewRadius;
+}
+
+bool RenderEngine::canReusePixels(const ViewState& view, RenderAlgorithm algorithm, std::vector<int>& previousColumns, std::vector<int>& previousRows) const {
+    if (!settings.reusePixels || previousFrameAlgorithm != algorithm || settings != previousFrameSettings)
+        return false;
+    // Subdivision, distance fill and progressive guesses depend on where the tiles are, they would not match a fresh frame
+    if (settings.rectangleSubdivision || settings.distanceFill || settings.progressiveRefinement)
+        return false;
+    // Perturbation counts depend on the reference orbit and the glitch references, which both move with the view
+    if (algorithm == RenderAlgorithm::Perturbation || algorithm == RenderAlgorithm::Bla)
+        return false;
+    const ViewState& previous = previousFrameView;
+    if (view.width != previous.width || view.height != previous.height || view.realPartStart != previous.realPartStart
+        || view.imagPartStart != previous.imagPartStart || view.latticeFractionLimbs() != previous.latticeFractionLimbs())
+        return false;
+
+    // Lattice index n is at n * zoomScale / width, so index n of this view is index n * 2^scale of the previous one
+    long double ratio = view.zoomScale / previous.zoomScale;
+    int scale = std::ilogb(ratio);
+    if (std::ldexp(1.0L, scale) != ratio || scale < -MAX_REUSE_SCALE || scale > MAX_REUSE_SCALE)
+        return false;
+    auto toPreviousIndex = [scale](std::int64_t index, std::int64_t& previousIndex) {
+        if (scale >= 0) {
+            previousIndex = index * (std::int64_t{1} << scale);
+            return true;
+        }
+        std::int64_t divisor = std::int64_t{1} << -scale;
+        previousIndex = index / divisor;
+        return index % divisor == 0;
+    };
+
+    // Columns are at index x + panX + 1, rows at height - y - panY (see `offsetFromLatticeOrigin`)
+    bool anyColumn = false;
+    previousColumns.assign(static_cast<std::size_t>(view.width), -1);
+    for (int x = 0; x < view.width; x++) {
+        std::int64_t index;
+        if (!toPreviousIndex(x + view.panX + 1, index))
+            continue;
+        std::int64_t previousX = index - previous.panX - 1;
+        if (previousX >= 0 && previousX < previous.width) {
+            previousColumns[static_cast<std::size_t>(x)] = static_cast<int>(previousX);
+            anyColumn = true;
+        }
+    }
+    bool anyRow = false;
+    previousRows.assign(static_cast<std::size_t>(view.height), -1);
+    for (int y = 0; y < view.height; y++) {
+        std::int64_t index;
+        if (!toPreviousIndex(view.height - y - view.panY, index))
+            continue;
+        std::int64_t previousY = previous.height - index - previous.panY;
+        if (previousY >= 0 && previousY < previous.height) {
+            previousRows[static_cast<std::size_t>(y)] = static_cast<int>(previousY);
+            anyRow = true;
+        }
+    }
+    return anyColumn && anyRow;
+}
+
+std::size_t RenderEngine::fillFromTileCache(const ViewState& view, RenderAlgorithm algorithm, IterationBuffer& buffer, std::vector<std::uint8_t>& reusedMask) {
+    constexpr std::int64_t SIZE = TileCache::TILE_SIZE;
+    if (reusedMask.empty())
+        reusedMask.assign(static_cast<std::size_t>(view.width) * static_cast<std::size_t>(view.height), 0);
+
+    // Counts up to the lower limit are the same under both limits, only points that did not escape may escape later
+    auto lookUp = [&view](const CachedTile* tile, std::int64_t column, std::int64_t row, std::uint32_t& count) {
+        if (!tile)
+            return false;
+        std::size_t index = static_cast<std::size_t>(row * SIZE + column);
+        if (!tile->valid[index])
+            return false;
+        count = tile->iterations[index];
+        if (count == 0 && view.maxIterations > tile->maxIterations)
+            return false;
+        if (count > view.maxIterations)
+            count = 0;
+        return true;
+    };
+
+    // Columns are at index x + panX + 1, rows at height - y - panY (see `offsetFromLatticeOrigin`)
+    std::int64_t firstColumn = view.panX + 1;
+    std::int64_t lastColumn = view.panX + view.width;
+    std::int64_t firstRow = 1 - view.panY;
+    std::int64_t lastRow = view.height - view.panY;
+    std::size_t cachedPixels = 0;
+    for (std::int64_t tileY = floorDivide(firstRow, SIZE); tileY <= floorDivide(lastRow, SIZE); tileY++) {
+        for (std::int64_t tileX = floorDivide(firstColumn, SIZE); tileX <= floorDivide(lastColumn, SIZE); tileX++) {
+            const CachedTile* tile = tileCache.find(makeTileKey(view, algorithm, view.zoomScale, tileX, tileY));
+
+            // Index n is index 2n at half the zoom, in one of four children, and index n / 2 at twice the zoom if n is even
+            const CachedTile* children[2][2] = {};
+            const CachedTile* parent = nullptr;
+            if (!tile || std::find(tile->valid.begin(), tile->valid.end(), std::uint8_t{0}) != tile->valid.end()) {
+                for (int b = 0; b < 2; b++) {
+                    for (int a = 0; a < 2; a++)
+                        children[b][a] = tileCache.peek(makeTileKey(view, algorithm, view.zoomScale / 2.0L, 2 * tileX + a, 2 * tileY + b));
+                }
+                parent = tileCache.peek(makeTileKey(view, algorithm, view.zoomScale * 2.0L, floorDivide(tileX, 2), floorDivide(tileY, 2)));
+            }
+
+            for (std::int64_t row = std::max(firstRow, tileY * SIZE); row <= std::min(lastRow, tileY * SIZE + SIZE - 1); row++) {
+                int y = static_cast<int>(view.height - row - view.panY);
+                for (std::int64_t column = std::max(firstColumn, tileX * SIZE); column <= std::min(lastColumn, tileX * SIZE + SIZE - 1); column++) {
+                    int x = static_cast<int>(column - view.panX - 1);
+                    std::size_t index = buffer.indexOf(x, y);
+                    if (reusedMask[index])
+                        continue;
+                    std::int64_t localColumn = column - tileX * SIZE;
+                    std::int64_t localRow = row - tileY * SIZE;
+                    std::uint32_t count;
+                    bool found = lookUp(tile, localColumn, localRow, count)
+                        || lookUp(children[2 * localRow / SIZE][2 * localColumn / SIZE], 2 * localColumn % SIZE, 2 * localRow % SIZE, count)
+                        || (column % 2 == 0 && row % 2 == 0
+                            && lookUp(parent, column / 2 - floorDivide(tileX, 2) * SIZE, row / 2 - floorDivide(tileY, 2) * SIZE, count));
+                    if (!found)
+                        continue;
+                    buffer.iterations[index] = count;
+                    reusedMask[index] = 1;
+                    cachedPixels++;
+                }
+            }
+        }
+    }
+    return cachedPixels;
+}
+
+void RenderEngine::storeInTileCache(const ViewState& view, RenderAlgorithm algorithm, const IterationBuffer& buffer, const std::vector<std::uint8_t>& glitchMask) {
+    constexpr std::int64_t SIZE = TileCache::TILE_SIZE;
+    std::int64_t firstColumn = view.panX + 1;
+    std::int64_t lastColumn = view.panX + view.width;
+    std::int64_t firstRow = 1 - view.panY;
+    std::int64_t lastRow = view.height - view.panY;
+    for (std::int64_t tileY = floorDivide(firstRow, SIZE); tileY <= floorDivide(lastRow, SIZE); tileY++) {
+        for (std::int64_t tileX = floorDivide(firstColumn, SIZE); tileX <= floorDivide(lastColumn, SIZE); tileX++) {
+            CachedTile* tile = tileCache.insert(makeTileKey(view, algorithm, view.zoomScale, tileX, tileY), view.maxIterations);
+            if (!tile)
+                return;
+            for (std::int64_t row = std::max(firstRow, tileY * SIZE); row <= std::min(lastRow, tileY * SIZE + SIZE - 1); row++) {
+                int y = static_cast<int>(view.height - row - view.panY);
+                for (std::int64_t column = std::max(firstColumn, tileX * SIZE); column <= std::min(lastColumn, tileX * SIZE + SIZE - 1); column++) {
+                    std::size_t index = buffer.indexOf(static_cast<int>(column - view.panX - 1), y);
+                    if (!glitchMask.empty() && glitchMask[index])
+                        continue;
+                    std::size_t tileIndex = static_cast<std::size_t>((row - tileY * SIZE) * SIZE + column - tileX * SIZE);
+                    tile->iterations[tileIndex] = buffer.iterations[index];
+                    tile->valid[tileIndex] = 1;
+                }
+            }
+        }
+    }
+}
+
+RenderAlgorithm RenderEngine::resolveAlgorithm(const ViewState& view) const {
+    if (settings.algorithm != RenderAlgorithm::Auto)
+        return settings.algorithm;
+    if (view.isDoublePrecisionSufficient())
+        return RenderAlgorithm::Direct;
+    // Double-double would also do down to about 1e-30, but one double-double iteration costs about ten double ones while the
+    // reference orbit of perturbation takes milliseconds and the series skips most iterations, so it wins on the CPU
+    return RenderAlgorithm::Perturbation;
+}
+
+std::vector<RenderStatistics> RenderEngine::benchmarkKernels(const ViewState& view) {
+    RenderSettings previousSettings = settings;
+    settings.tileCacheMemory = 0; // Every frame is iterated in full
+
+    std::vector<RenderStatistics> results;
+    for (KernelIsa isa : supportedIsas()) {
+        settings.isa = isa;
+        for (KernelMode mode : {KernelMode::Batched, KernelMode::Streaming}) {
+            if (isa == KernelIsa::Scalar && mode == KernelMode::Streaming)
+                continue; // Same kernel as batched
+            settings.kernelMode = mode;
+            render(view);
+            results.push_back(lastStatistics);
+        }
+    }
+
+    settings = previousSettings;
+    return results;
+}
+
+std::vector<RenderStatistics> RenderEngine::benchmarkAlgorithms(const ViewState& view) {
+    RenderSettings previousSettings = settings;
+    settings.tileCacheMemory = 0;
+
+    std::vector<RenderStatistics> results;
+    for (RenderAlgorithm algorithm : {RenderAlgorithm::Direct, RenderAlgorithm::DoubleDouble, RenderAlgorithm::FixedPoint, RenderAlgorithm::Perturbation}) {
+        settings.algorithm = algorithm;
+        render(view);
+        results.push_back(lastStatistics);
+    }
+
+    settings = previousSettings;
+    return results;
+}
+
+SubdivisionCheck RenderEngine::checkSubdivision(const ViewState& view) {
+    RenderSettings previousSettings = settings;
+    SubdivisionCheck check;
+    settings.tileCacheMemory = 0;
+
+    settings.rectangleSubdivision = true;
+    IterationBuffer subdivided = render(view);
+    check.filledPixels = lastStatistics.filledPixels;
+    check.subdividedSeconds = lastStatistics.seconds;
+
+    settings.rectangleSubdivision = false;
+    IterationBuffer full = render(view);
+    check.fullSeconds = lastStatistics.seconds;
+
+    check.pixels = full.iterations.size();
+    for (std::size_t i = 0; i < check.pixels; i++)
+        check.wrongPixels += subdivided.iterations[i] != full.iterations[i] ? 1u : 0u;
+
+    settings = previousSettings;
+    return check;
+}
+
+ReuseCheck RenderEngine::checkReuse(const ViewState& first, const ViewState& second) {
+    RenderSettings previousSettings = settings;
+    ReuseCheck check;
+
+    settings.reusePixels = true;
+    render(first);
+    IterationBuffer reused = render(second);
+    check.reusedPixels = lastStatistics.reusedPixels;
+    check.cachedPixels = lastStatistics.cachedPixels;
+    check.reusingSeconds = lastStatistics.seconds;
+
+    settings.reusePixels = false;
+    settings.tileCacheMemory = 0;
+    IterationBuffer full = render(second);
+    check.fullSeconds = lastStatistics.seconds;
+
+    check.pixels = full.iterations.size();
+    for (std::size_t i = 0; i < check.pixels; i++)
+        check.wrongPixels += reused.iterations[i] != full.iterations[i] ? 1u : 0u;
+
+    settings = previousSettings;
+    return check;
+}
@@ -0,0 +1,292 @@
+#pragma once
+#ifndef MANDELBROT_RENDERENGINE_INCLUDED
+#define MANDELBROT_RENDERENGINE_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "view_state.h"
+#include "frame_buffer.h"
+#include "cpu_features.h"
+#include "iteration_kernel.h"
+#include "thread_pool.h"
+#include "reference_orbit.h"
+#include "series_approximation.h"
+#include "bla_table.h"
+#include "tile_cache.h"
+
+/**
+ * How the engine computes the iteration counts
+ */
+enum class RenderAlgorithm {
+    Auto = 0,         // Direct while double pixel coordinates are precise enough, perturbation beyond that
+    Direct = 1,       // Every pixel is iterated in double with the SIMD kernels
+    Perturbation = 2, // One high-precision reference orbit at the view center, the pixels iterate their offset to it
+    Bla = 3,          // Perturbation that jumps many iterations at once with bilinear approximations, rebasing to the orbit start
+    DoubleDouble = 4, // Every pixel is iterated in double-double (about 106 bits), for views just beyond the precision of double
+    FixedPoint = 5,   // Every pixel is iterated in 128 bit fixed point (120 fraction bits), or 64 bit (56) in the few zoom levels where that is enough and double is not
+};
+
+const char* renderAlgorithmName(RenderAlgorithm algorithm);
+
+/**
+ * Numbers collected while rendering a frame
+ */
+struct RenderStatistics {
+    KernelIsa isa = KernelIsa::Scalar; // Instruction set level of the kernel that was used
+    KernelMode kernelMode = KernelMode::Batched;
+    RenderAlgorithm algorithm = RenderAlgorithm::Direct; // Never `Auto`, this is what auto resolved to
+    unsigned int fixedPointBits = 0; // Width of the integers of fixed-point frames (64 or 128), 0 for the other algorithms
+    std::size_t referenceIterations = 0; // Length of the reference orbit (perturbation only)
+    double referenceSeconds = 0.0; // Time spent computing the reference orbit, included in `seconds`
+    bool referenceReused = false; // Whether the reference orbit of an earlier frame was used, see `RenderEngine::canReuseReference`
+    std::size_t referenceBytes = 0; // Memory of the stored reference orbit
+    bool referenceCompressed = false; // Whether the reference orbit was over the memory limit and is stored compressed (frame then uses no BLA)
+    unsigned int referencePeriod = 0; // Period of the minibrot nucleus used as reference, 0 if the reference is the view center
+    std::uint32_t seriesSkippedIterations = 0; // Iterations every pixel skipped thanks to the series approximation
+    double seriesErrorBound = 0.0; // Estimated relative error of the deltas the series approximation handed to the pixels
+    std::vector<std::size_t> blaLevelBytes; // Memory of each level of the BLA table, level 0 (single steps) first (BLA only)
+    bool rescaledDeltas = false; // Whether the deltas were iterated with a separate exponent because the frame is below the range of double
+    std::size_t glitchedPixels = 0; // Pixels that glitched against the main reference (perturbation without BLA only)
+    unsigned int glitchPasses = 0; // Re-render passes with extra references it took to correct them
+    std::size_t glitchReferences = 0; // Extra reference orbits over all passes
+    std::size_t remainingGlitches = 0; // Pixels that were still glitched after the last pass
+    std::uint64_t iterations = 0; // Number of escape-time iterations that were executed
+    double laneUtilization = 1.0; // Fraction of SIMD lanes that did useful work
+    std::size_t bulbPixels = 0; // Pixels the main cardioid / period-2 bulb test settled without iterating (direct only)
+    std::size_t periodicPixels = 0; // Pixels stopped early because their orbit repeated exactly (direct only)
+    std::size_t filledPixels = 0; // Pixels filled by rectangle subdivision without iterating them
+    std::size_t provenPixels = 0; // Pixels filled because ball arithmetic proved their rectangle uniform (direct and double-double only)
+    std::size_t distancePixels = 0; // Pixels filled from the distance estimate of a nearby pixel (direct only)
+    std::size_t guessedPixels = 0; // Pixels of progressive frames whose neighbours on the coarser level agreed, not iterated
+    std::size_t reusedPixels = 0; // Pixels copied from the frame before because the views share lattice points, see `reusePixels`
+    std::size_t cachedPixels = 0; // Pixels taken from the tile cache (of this zoom level or a neighbouring one), see `tileCacheMemory`
+    TileCacheStatistics tileCache; // State of the tile cache after the frame
+    unsigned int threadCount = 1;
+    std::size_t tileCount = 0;
+    std::size_t droppedTiles = 0; // Tiles that were skipped because the view epoch moved on, the frame is incomplete if this is not 0
+    std::uint64_t steals = 0; // Tiles a worker took from another worker's deque
+    double seconds = 0.0;
+
+    inline double megaIterationsPerSecond() const { return seconds > 0.0 ? static_cast<double>(iterations) / seconds * 1e-6 : 0.0; }
+};
+
+/**
+ * Options that control how the engine computes a frame (but not what it computes)
+ */
+struct RenderSettings {
+    KernelIsa isa = bestSupportedIsa(); // Falls back to the scalar kernel if the CPU does not support it
+    KernelMode kernelMode = KernelMode::Streaming;
+    unsigned int threadCount = 0; // 0 means one per hardware thread
+    int tileSize = 64; // Edge length of the square tiles the frame is split into (rounded up to a multiple of 4 for progressive frames)
+    RenderAlgorithm algorithm = RenderAlgorithm::Auto;
+    unsigned int seriesTerms = 6; // Terms of the series approximation of perturbation frames, less than 2 disables it
+    // Bytes a reference orbit may take, longer ones are compressed. The extra references of the glitch correction share
+    // one more limit, so a frame holds at most twice this in orbits
+    std::size_t referenceMemoryLimit = std::size_t{1} << 30;
+    bool nucleusReference = false; // Perturbation frames use the nucleus of the largest minibrot in view as reference, if there is one
+    bool rectangleSubdivision = false; // Mariani-Silver: rectangles whose border has one count are filled with it, may miss thin features
+    bool provenTiles = false; // Tiles (or their quarters) that ball arithmetic proves uniform are filled, never wrong (direct and double-double only)
+    // Pixels within the distance estimate of a computed pixel get its count (direct only). Interior disks are exact, the
+    // exterior ones only get the side of the boundary right, so they are filled with `membershipOnly` alone
+    bool distanceFill = false;
+    bool membershipOnly = false; // Only set versus not set matters to the caller (black/white), not the exterior counts
+    // Every tile is rendered at 1/16, then 1/4, then all of the pixels, each level is reported through `onTileDone`.
+    // Pixels whose neighbours on the level before agree are guessed. Takes the place of the three options above
+    bool progressiveRefinement = false;
+    // When a view is on the lattice of the last complete frame (moved by whole pixels with `ViewState::panX`, `panY`, or zoomed
+    // by a power of two), the points they share are copied and only the others are iterated. Not with the three options
+    // above, whose guesses depend on the tile grid, nor with perturbation, whose counts depend on the reference orbit
+    bool reusePixels = true;
+    // Complete frames are kept as tiles of their lattice, in a least recently used cache of this size (0 disables it).
+    // Points of later frames on the same lattice, at the same zoom or a power of two away, are taken from it. Not with
+    // perturbation, whose counts depend on the reference orbit, nor with the guessing options above
+    std::size_t tileCacheMemory = std::size_t{256} << 20;
+
+    bool operator==(const RenderSettings& other) const = default;
+};
+
+/**
+ * Result of `RenderEngine::checkSubdivision`
+ */
+struct SubdivisionCheck {
+    std::size_t pixels = 0;
+    std::size_t filledPixels = 0; // Pixels the subdivided frame filled without iterating
+    std::size_t wrongPixels = 0; // Pixels whose count differs from the full frame
+    double subdividedSeconds = 0.0;
+    double fullSeconds = 0.0;
+};
+
+/**
+ * Result of `RenderEngine::checkReuse`
+ */
+struct ReuseCheck {
+    std::size_t pixels = 0;
+    std::size_t reusedPixels = 0; // Pixels the second frame copied from the first
+    std::size_t cachedPixels = 0; // Pixels the second frame took from the tile cache
+    std::size_t wrongPixels = 0; // Pixels whose count differs from rendering the second view from scratch
+    double reusingSeconds = 0.0;
+    double fullSeconds = 0.0;
+};
+
+/**
+ * Timing of a single tile of the last frame
+ */
+struct TileReport {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    int worker = -1; // Index of the pool worker that rendered the tile, -1 if the tile was dropped
+    double milliseconds = 0.0;
+    std::uint64_t iterations = 0;
+};
+
+/**
+ * Optional per-frame parameters of `RenderEngine::render`
+ */
+struct FrameRequest {
+    // Pixel that should be finished first, tiles are started in order of their distance to it (-1 means the center of the view)
+    int focusX = -1;
+    int focusY = -1;
+
+    // Called from the worker threads whenever a tile of the current epoch is written to the buffer. The tile is only safe to
+    // read during the call, progressive frames write it again on their next level
+    std::function<void(const TileReport&)> onTileDone;
+};
+
+/**
+ * Computes frames on the CPU, without needing OpenGL or a window
+ */
+class RenderEngine {
+
+protected:
+    RenderSettings settings;
+    RenderStatistics lastStatistics;
+    std::vector<TileReport> lastTileReports;
+    std::unique_ptr<ThreadPool> threadPool;
+    std::atomic<std::uint64_t> viewEpoch{0};
+    ReferenceOrbit referenceOrbit;
+    SeriesApproximation seriesApproximation;
+    BlaTable blaTable;
+    bool referenceFromNucleusSearch = false; // Whether `referenceOrbit` was chosen with `nucleusReference` on, even if no nucleus was found
+    // Last complete frame and what it was rendered with, for `reusePixels`
+    IterationBuffer previousFrame;
+    ViewState previousFrameView;
+    RenderSettings previousFrameSettings;
+    RenderAlgorithm previousFrameAlgorithm = RenderAlgorithm::Auto; // `Auto` while there is no previous frame
+    TileCache tileCache;
+    RenderSettings tileCacheSettings; // Settings of the frames in `tileCache`, it is cleared when they would give other counts
+
+public:
+    RenderEngine() = default;
+    explicit RenderEngine(const RenderSettings& initialSettings) : settings{initialSettings} {}
+
+    inline const RenderSettings& getSettings() const { return settings; }
+    inline void setSettings(const RenderSettings& newSettings) { settings = newSettings; }
+
+    /**
+     * Computes the iteration count of every pixel of `view`
+     */
+    IterationBuffer render(const ViewState& view);
+
+    /**
+     * Computes the iteration counts of `view` into `buffer`, tile by tile
+     *
+     * The frame belongs to the view epoch that is current when the call starts. Once `advanceEpoch` is called,
+     * workers drop the tiles of this frame that they have not started yet and the call returns early.
+     *
+     * @param buffer Needs to have the size of `view`, tiles that get dropped keep their previous content
+     */
+    void render(const ViewState& view, IterationBuffer& buffer, const FrameRequest& request);
+
+    /**
+     * Marks every frame that is currently being rendered as stale, can be called from any thread
+     */
+    inline void advanceEpoch() { viewEpoch.fetch_add(1); }
+    inline std::uint64_t getEpoch() const { return viewEpoch.load(); }
+
+    /**
+     * Renders `view` and applies `flowColor` to the result
+     */
+    RgbImage renderImage(const ViewState& view, FlowColorType colorType);
+
+    inline const RenderStatistics& getLastStatistics() const { return lastStatistics; }
+
+    /**
+     * @return One entry per tile of the last frame, in the order the tiles were created (row by row)
+     */
+    inline const std::vector<TileReport>& getLastTileReports() const { return lastTileReports; }
+
+    /**
+     * Renders `view` once with every instruction set level this machine supports (SIMD levels in both kernel modes)
+     *
+     * @return The statistics of each run (narrowest instruction set first), use `megaIterationsPerSecond` to compare them
+     */
+    std::vector<RenderStatistics> benchmarkKernels(const ViewState& view);
+
+    /**
+     * Renders `view` once with each algorithm that iterates every pixel on its own (direct, double-double and fixed point)
+     * and once with perturbation, all with the current instruction set
+     *
+     * Direct still runs where double no longer resolves the pixels, its image is wrong but its speed is the baseline.
+     *
+     * @return The statistics of each run, use `megaIterationsPerSecond` or `seconds` to compare them
+     */
+    std::vector<RenderStatistics> benchmarkAlgorithms(const ViewState& view);
+
+    /**
+     * Renders `view` once with and once without rectangle subdivision (otherwise with the current settings)
+     *
+     * @return How many pixels the subdivision filled, and how many of them got a different count than iterating them
+     */
+    SubdivisionCheck checkSubdivision(const ViewState& view);
+
+    /**
+     * Renders `first`, then `second` reusing the first frame, and `second` once more without reuse (otherwise with the current settings)
+     *
+     * @return How many pixels the second frame reused, and how many of them got a different count than rendering from scratch
+     */
+    ReuseCheck checkReuse(const ViewState& first, const ViewState& second);
+
+    /**
+     * @return The algorithm `render` uses for `view` with the current settings (never `Auto`)
+     */
+    RenderAlgorithm resolveAlgorithm(const ViewState& view) const;
+
+protected:
+    ThreadPool& getThreadPool();
+
+    /**
+     * @param shift Offset from the center of the cached reference orbit to the center of `view`
+     * @param viewRadius Distance from the center of `view` to its farthest pixel
+     * @return Whether the cached reference orbit can serve `view`: chosen the same way, precise and long enough, and still inside the frame
+     */
+    bool canReuseReference(const ViewState& view, const ComplexNum& shift, long double viewRadius) const;
+
+    /**
+     * @param previousColumns Receives the column of the previous frame at the lattice index of each column of `view`, -1 where it has none
+     * @param previousRows Receives the same for the rows
+     * @return Whether `view` shares lattice points with the previous frame and is rendered the same way
+     */
+    bool canReusePixels(const ViewState& view, RenderAlgorithm algorithm, std::vector<int>& previousColumns, std::vector<int>& previousRows) const;
+
+    /**
+     * Copies the points of `view` the tile cache holds, at the zoom of `view` or one power of two away, into the pixels
+     * `reusedMask` does not have yet, and marks them
+     *
+     * @return The number of pixels copied
+     */
+    std::size_t fillFromTileCache(const ViewState& view, RenderAlgorithm algorithm, IterationBuffer& buffer, std::vector<std::uint8_t>& reusedMask);
+
+    /**
+     * Stores the complete frame in the tile cache, except for pixels that are still glitched
+     */
+    void storeInTileCache(const ViewState& view, RenderAlgorithm algorithm, const IterationBuffer& buffer, const std::vector<std::uint8_t>& glitchMask);
+
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "series_approximation.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SeriesApproximation::compute(const ReferenceOrbit& reference, const FloatExp& deltaScale, double frameRadius, unsigned int terms,
+    unsigned int maxIterations)
+{
+    coefficients.assign(terms, ComplexExp{});
+    radius = frameRadius;
+    skipIterations = 0;
+    errorBound = 0.0;
+    if (terms < 2 || radius <= 0.0 || reference.size() < 2)
+        return;
+
+    // The pixels continue from the skip iteration, which needs at least one more orbit point for them to step to
+    std::size_t limit = std::min<std::size_t>(maxIterations, reference.size() - 2);
+    FloatExp scaledRadius = deltaScale * radius;
+    if (reference.isCompressed())
+        iterate(CompressedOrbitReader{reference, 0}, limit, scaledRadius);
+    else
+        iterate(DenseOrbitReader{reference, 0}, limit, scaledRadius);
+}
+
+template<class OrbitReader>
+void SeriesApproximation::iterate(OrbitReader orbit, std::size_t limit, const FloatExp& scaledRadius) {
+    std::size_t terms = coefficients.size();
+    std::vector<ComplexExp> next(terms);
+    for (std::size_t n = 0; n < limit; n++) {
+        // d_(n+1) = 2 Z_n d_n + d_n^2 + delta, split by powers of delta
+        for (std::size_t k = 0; k < terms; k++) {
+            ComplexExp value = coefficients[k].multiplied(2.0 * orbit.getReal(), 2.0 * orbit.getImag());
+            for (std::size_t i = 0; i + 1 <= k; i++)
+                value = value + coefficients[i] * coefficients[k - 1 - i];
+            next[k] = value;
+        }
+        next[0].real += scaledRadius;
+        orbit.advance();
+
+        FloatExp linear = next[0].magnitude();
+        FloatExp last = next[terms - 1].magnitude();
+        if ((linear * ERROR_TOLERANCE).isSmallerThan(last))
+            break;
+
+        // Every pixel has to be still inside the escape radius, otherwise it would have stopped before the skip
+        FloatExp deltaBound;
+        for (const ComplexExp& coefficient : next)
+            deltaBound += coefficient.magnitude();
+        if (std::hypot(orbit.getReal(), orbit.getImag()) + deltaBound.toDouble() > 2.0)
+            break;
+
+        coefficients.swap(next);
+        skipIterations = static_cast<std::uint32_t>(n + 1);
+        errorBound = linear.isZero() ? 0.0 : (last / linear).toDouble();
+    }
+}
+
+ComplexExp SeriesApproximation::evaluate(double deltaReal, double deltaImag) const {
+    double uReal = deltaReal / radius;
+    double uImag = deltaImag / radius;
+    ComplexExp value;
+    for (std::size_t k = coefficients.size(); k-- > 0;)
+        value = (value + coefficients[k]).multiplied(uReal, uImag);
+    return value;
+}
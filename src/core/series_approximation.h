@@ -0,0 +1,66 @@
+#pragma once
+#ifndef MANDELBROT_SERIESAPPROXIMATION_INCLUDED
+#define MANDELBROT_SERIESAPPROXIMATION_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "float_exp.h"
+#include "reference_orbit.h"
+
+/**
+ * Polynomial approximation of the perturbation deltas, lets every pixel of a frame skip the first iterations
+ *
+ * For the pixel offset `delta`, `d_n = sum(a_(n,k) * delta^(k+1))` with coefficients that only depend on the reference
+ * orbit. The coefficients are stored scaled by `radius^(k+1)` and the polynomial is evaluated in `u = delta / radius`,
+ * `|u| <= 1`. They are kept as `FloatExp`, because below 1e-308 even the linear term is out of range of `double`.
+ * The series is used as long as its last term stays negligible compared to the linear term for every pixel of the frame.
+ */
+class SeriesApproximation {
+
+protected:
+    std::vector<ComplexExp> coefficients; // Scaled coefficients at iteration `skipIterations`, lowest power first
+    double radius = 0.0; // In units of `deltaScale`
+    std::uint32_t skipIterations = 0;
+    double errorBound = 0.0;
+
+public:
+    /**
+     * Relative size of the last series term at which the approximation stops being used
+     */
+    static constexpr double ERROR_TOLERANCE = 0x1p-40;
+
+    /**
+     * @param reference Reference orbit of the frame
+     * @param deltaScale Unit of the pixel offsets, see `iteratePerturbation`
+     * @param frameRadius Largest distance of a pixel of the frame to the reference, in units of `deltaScale`
+     * @param terms Number of terms of the polynomial, less than 2 disables the approximation
+     * @param maxIterations Iteration limit of the frame
+     */
+    void compute(const ReferenceOrbit& reference, const FloatExp& deltaScale, double frameRadius, unsigned int terms, unsigned int maxIterations);
+
+    /**
+     * @return The iteration the approximation reaches, every pixel continues from there (0 if the approximation is not used)
+     */
+    inline std::uint32_t getSkipIterations() const { return skipIterations; }
+
+    /**
+     * @return Size of the last term relative to the linear term at `getSkipIterations()`, an estimate of the relative error of the deltas
+     */
+    inline double getErrorBound() const { return errorBound; }
+
+    /**
+     * @return The delta at `getSkipIterations()` of the pixel with offset `delta` (in units of `deltaScale`) to the reference
+     */
+    ComplexExp evaluate(double deltaReal, double deltaImag) const;
+
+protected:
+    /**
+     * Advances the coefficients along the orbit until they stop being accurate or `limit` is reached
+     */
+    template<class OrbitReader>
+    void iterate(OrbitReader orbit, std::size_t limit, const FloatExp& scaledRadius);
+
+};
+
+#endif
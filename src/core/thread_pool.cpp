@@ -0,0 +1,111 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace {
+
+struct WorkerIdentity {
+    const ThreadPool* pool = nullptr;
+    int index = -1;
+};
+
+thread_local WorkerIdentity currentWorkerIdentity;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        queues.push_back(std::make_unique<WorkerQueue>());
+    for (unsigned int i = 0; i < threadCount; i++)
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{sleepMutex};
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+int ThreadPool::currentWorker() const {
+    return currentWorkerIdentity.pool == this ? currentWorkerIdentity.index : -1;
+}
+
+void ThreadPool::submit(Task task) {
+    int worker = currentWorker();
+    std::size_t index = worker >= 0 ? static_cast<std::size_t>(worker) : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    unfinishedTasks.fetch_add(1);
+    {
+        // Taking the lock makes sure a worker that is about to sleep sees the new task
+        std::lock_guard<std::mutex> lock{sleepMutex};
+        queuedTasks.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> lock{queues[index]->mutex};
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wakeCondition.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock{sleepMutex};
+    idleCondition.wait(lock, [this] { return unfinishedTasks.load() == 0; });
+}
+
+bool ThreadPool::popTask(unsigned int index, Task& task) {
+    {
+        WorkerQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock{own.mutex};
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker, oldest tasks tend to be the biggest chunks of work
+    for (std::size_t offset = 1; offset < queues.size(); offset++) {
+        WorkerQueue& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock{victim.mutex};
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stealCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::finishTask() {
+    if (unfinishedTasks.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock{sleepMutex};
+        idleCondition.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    currentWorkerIdentity = {this, static_cast<int>(index)};
+
+    while (true) {
+        Task task;
+        if (popTask(index, task)) {
+            queuedTasks.fetch_sub(1);
+            task();
+            finishTask();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{sleepMutex};
+        wakeCondition.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+        if (stopping)
+            return;
+    }
+}
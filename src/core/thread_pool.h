@@ -0,0 +1,82 @@
+#pragma once
+#ifndef MANDELBROT_THREADPOOL_INCLUDED
+#define MANDELBROT_THREADPOOL_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed-size thread pool with one task deque per worker and work stealing
+ *
+ * A worker takes tasks from the back of its own deque and, once that is empty, steals from the front of
+ * the other deques. Tasks submitted from outside the pool are spread round-robin over the deques, tasks
+ * submitted by a worker go to its own deque.
+ */
+class ThreadPool {
+
+public:
+    using Task = std::function<void()>;
+
+protected:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition; // Signaled when tasks are queued or the pool stops
+    std::condition_variable idleCondition; // Signaled when the last unfinished task is done
+    std::atomic<std::size_t> queuedTasks{0};
+    std::atomic<std::size_t> unfinishedTasks{0}; // Queued and running tasks
+    std::atomic<std::size_t> nextQueue{0};
+    std::atomic<std::uint64_t> stealCount{0};
+    bool stopping = false;
+
+public:
+    /**
+     * @param threadCount Number of worker threads, 0 means one per hardware thread
+     */
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    /**
+     * Blocks until every submitted task has finished
+     * Must not be called from inside a task.
+     */
+    void wait();
+
+    inline unsigned int getThreadCount() const { return static_cast<unsigned int>(threads.size()); }
+
+    /**
+     * @return Index of the worker running the calling thread, or -1 if the caller is not a worker of this pool
+     */
+    int currentWorker() const;
+
+    /**
+     * @return How many tasks were taken from another worker's deque since the pool was created
+     */
+    inline std::uint64_t getStealCount() const { return stealCount.load(std::memory_order_relaxed); }
+
+protected:
+    void workerLoop(unsigned int index);
+    bool popTask(unsigned int index, Task& task);
+    void finishTask();
+
+};
+
+#endif
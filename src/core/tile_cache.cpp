@@ -0,0 +1,90 @@
+#include "tile_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+std::size_t TileKeyHash::operator()(const TileKey& key) const {
+    // The start values only go in with long double precision, equal keys still compare all of their digits
+    std::size_t hash = std::hash<long double>{}(key.zoomScale);
+    auto combine = [&hash](std::size_t value) { hash ^= value + 0x9e3779b97f4a7c15 + (hash << 6) + (hash >> 2); };
+    combine(std::hash<std::int64_t>{}(key.tileX));
+    combine(std::hash<std::int64_t>{}(key.tileY));
+    combine(std::hash<long double>{}(key.realPartStart.toLongDouble()));
+    combine(std::hash<long double>{}(key.imagPartStart.toLongDouble()));
+    combine(std::hash<int>{}(key.precision));
+    combine(std::hash<int>{}(key.fractionLimbs));
+    combine(std::hash<int>{}(key.width));
+    combine(std::hash<int>{}(key.height));
+    return hash;
+}
+
+std::size_t TileCache::tileBytes(const TileKey& key) {
+    constexpr std::size_t POINTS = static_cast<std::size_t>(TILE_SIZE) * static_cast<std::size_t>(TILE_SIZE);
+    // The key is stored twice, in the entry and in the index, deep views have many limbs per start value
+    std::size_t limbs = static_cast<std::size_t>(key.realPartStart.getFractionLimbs() + key.imagPartStart.getFractionLimbs() + 2);
+    return POINTS * (sizeof(std::uint32_t) + sizeof(std::uint8_t)) + sizeof(Entry) + sizeof(TileKey) + 2 * sizeof(void*)
+        + 2 * limbs * sizeof(std::uint32_t);
+}
+
+const CachedTile* TileCache::find(const TileKey& key) {
+    auto found = index.find(key);
+    if (found == index.end()) {
+        statistics.misses++;
+        return nullptr;
+    }
+    statistics.hits++;
+    entries.splice(entries.begin(), entries, found->second);
+    return &found->second->tile;
+}
+
+const CachedTile* TileCache::peek(const TileKey& key) const {
+    auto found = index.find(key);
+    return found != index.end() ? &found->second->tile : nullptr;
+}
+
+CachedTile* TileCache::insert(const TileKey& key, unsigned int maxIterations) {
+    constexpr std::size_t POINTS = static_cast<std::size_t>(TILE_SIZE) * static_cast<std::size_t>(TILE_SIZE);
+    auto found = index.find(key);
+    if (found != index.end()) {
+        entries.splice(entries.begin(), entries, found->second);
+        CachedTile& tile = found->second->tile;
+        if (tile.maxIterations != maxIterations) {
+            tile.maxIterations = maxIterations;
+            std::fill(tile.valid.begin(), tile.valid.end(), std::uint8_t{0});
+        }
+        return &tile;
+    }
+
+    std::size_t bytes = tileBytes(key);
+    if (memoryBudget < bytes)
+        return nullptr;
+    while (statistics.bytes + bytes > memoryBudget)
+        evictLeastRecentlyUsed();
+
+    entries.push_front({key, {maxIterations, std::vector<std::uint32_t>(POINTS, 0), std::vector<std::uint8_t>(POINTS, 0)}});
+    index.emplace(key, entries.begin());
+    statistics.tiles++;
+    statistics.bytes += bytes;
+    return &entries.front().tile;
+}
+
+void TileCache::setMemoryBudget(std::size_t budget) {
+    memoryBudget = budget;
+    while (statistics.bytes > memoryBudget)
+        evictLeastRecentlyUsed();
+}
+
+void TileCache::clear() {
+    entries.clear();
+    index.clear();
+    statistics.tiles = 0;
+    statistics.bytes = 0;
+}
+
+void TileCache::evictLeastRecentlyUsed() {
+    statistics.bytes -= tileBytes(entries.back().key);
+    index.erase(entries.back().key);
+    entries.pop_back();
+    statistics.evictions++;
+    statistics.tiles--;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef MANDELBROT_TILECACHE_INCLUDED
+#define MANDELBROT_TILECACHE_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "big_fixed.h"
+
+/**
+ * Identifies a square of `TileCache::TILE_SIZE` lattice points: everything that decides their coordinates, and so their counts
+ *
+ * The lattice is the one of `ViewState` (see `ViewState::offsetFromLatticeOrigin`), tile (x, y) holds the column indices
+ * `x * TILE_SIZE` up to `(x + 1) * TILE_SIZE - 1` and the row indices likewise. Keys that only differ in `zoomScale` by a
+ * factor of two are neighbouring levels of a quadtree: every point of a tile is also a point of one of its four children.
+ */
+struct TileKey {
+    int precision = 0; // The number format the counts were iterated in (`RenderAlgorithm`)
+    BigFixed realPartStart;
+    BigFixed imagPartStart;
+    int fractionLimbs = 0; // `ViewState::latticeFractionLimbs`
+    int width = 0;
+    int height = 0;
+    long double zoomScale = 0.0L; // The zoom level
+    std::int64_t tileX = 0;
+    std::int64_t tileY = 0;
+
+    bool operator==(const TileKey& other) const = default;
+};
+
+struct TileKeyHash {
+    std::size_t operator()(const TileKey& key) const;
+};
+
+/**
+ * Iteration counts of the points of one tile, row index 0 first
+ */
+struct CachedTile {
+    unsigned int maxIterations = 0; // Iteration limit the counts were computed with
+    std::vector<std::uint32_t> iterations;
+    std::vector<std::uint8_t> valid; // Whether each point was computed, frames at the edge of a tile only cover part of it
+};
+
+struct TileCacheStatistics {
+    std::uint64_t hits = 0; // Lookups that found the tile
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0; // Tiles dropped to stay within the memory budget
+    std::size_t tiles = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * Least recently used cache of computed tiles, within a memory budget
+ */
+class TileCache {
+
+public:
+    static constexpr int TILE_SIZE = 64;
+
+protected:
+    struct Entry {
+        TileKey key;
+        CachedTile tile;
+    };
+
+    std::list<Entry> entries; // Most recently used first
+    std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> index;
+    std::size_t memoryBudget = 0;
+    TileCacheStatistics statistics;
+
+public:
+    TileCache() = default;
+    explicit TileCache(std::size_t budget) : memoryBudget{budget} {}
+
+    /**
+     * @return Memory one tile takes, with its key (and the limbs of its start values) and bookkeeping
+     */
+    static std::size_t tileBytes(const TileKey& key);
+
+    /**
+     * Looks up a tile and marks it as recently used, counted as hit or miss
+     *
+     * @return The tile, nullptr if it is not cached. Valid until the next `insert`
+     */
+    const CachedTile* find(const TileKey& key);
+
+    /**
+     * Looks up a tile without counting or marking it (for the neighbouring levels of a tile that was not found)
+     */
+    const CachedTile* peek(const TileKey& key) const;
+
+    /**
+     * Gets the tile to store counts into, the existing one if it was computed with the same limit, otherwise a new
+     * tile without valid points. Evicts the least recently used tiles to make room.
+     *
+     * @return The tile, nullptr if the budget does not fit a single tile
+     */
+    CachedTile* insert(const TileKey& key, unsigned int maxIterations);
+
+    /**
+     * Evicts tiles until the cache fits in `budget` bytes
+     */
+    void setMemoryBudget(std::size_t budget);
+
+    void clear();
+
+    inline const TileCacheStatistics& getStatistics() const { return statistics; }
+
+protected:
+    void evictLeastRecentlyUsed();
+
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "tile_proof.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Relative rounding margin of every bound, 8 machine epsilons is well above what the few operations of a step lose
+constexpr double MARGIN = 8.0 * std::numeric_limits<double>::epsilon();
+
+} // namespace
+
+TileProof proveDisk(double centerReal, double centerImag, double radius, unsigned int maxIterations, std::uint32_t& escapeIteration) {
+    double real = centerReal;
+    double imag = centerImag;
+    double ballRadius = radius * (1.0 + MARGIN);
+    double savedReal = 0.0;
+    double savedImag = 0.0;
+    double savedRadius = -1.0; // Nothing saved yet
+    std::uint32_t nextSave = 1;
+
+    for (std::uint32_t n = 1; n < maxIterations + 1; n++) {
+        double magnitude = std::sqrt(real * real + imag * imag);
+        double nearest = magnitude * (1.0 - MARGIN) - ballRadius;
+        double farthest = (magnitude + ballRadius) * (1.0 + MARGIN);
+        if (nearest > 2.0 * (1.0 + MARGIN)) {
+            escapeIteration = n;
+            return TileProof::Escaped;
+        }
+        if (farthest >= 2.0 * (1.0 - MARGIN))
+            return TileProof::None;
+
+        if (savedRadius >= 0.0 && std::sqrt((real - savedReal) * (real - savedReal) + (imag - savedImag) * (imag - savedImag)) * (1.0 + MARGIN) + ballRadius <= savedRadius * (1.0 - MARGIN))
+            return TileProof::Bounded;
+        if (n == nextSave) {
+            // Iterating on from a larger ball is still an enclosure, and gives the later balls room to fall inside it
+            ballRadius *= 2.0;
+            savedReal = real;
+            savedImag = imag;
+            savedRadius = ballRadius;
+            nextSave *= 2;
+        }
+
+        // |(z + d)^2 - z^2| <= 2 |z| |d| + |d|^2, plus the rounding of the center and of any point of the ball
+        double largestReal = std::fabs(real) + ballRadius;
+        double largestImag = std::fabs(imag) + ballRadius;
+        double rounding = MARGIN * ((largestReal + largestImag) * (largestReal + largestImag) + std::fabs(centerReal) + std::fabs(centerImag) + radius);
+        ballRadius = (2.0 * magnitude * (1.0 + MARGIN) * ballRadius + ballRadius * ballRadius + radius + rounding) * (1.0 + MARGIN);
+
+        double realTemp = real;
+        real = (real * real) - (imag * imag) + centerReal;
+        imag = 2.0 * realTemp * imag + centerImag;
+    }
+    return TileProof::Bounded;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef MANDELBROT_TILEPROOF_INCLUDED
+#define MANDELBROT_TILEPROOF_INCLUDED
+
+#include <cstdint>
+
+/**
+ * What `proveDisk` could show about every point of a disk
+ */
+enum class TileProof {
+    None,    // Nothing, the points have to be iterated
+    Escaped, // Every point escapes in the same iteration
+    Bounded, // No point escapes within the iteration limit (they may all be interior, or just slow)
+};
+
+/**
+ * Iterates the disk of starting points `c` with `|c - center| <= radius` as one ball: a center orbit with a radius
+ * that encloses the orbit of every point of the disk
+ *
+ * Each step adds a bound of the rounding error of the center and of the pixel kernels to the radius, so the ball also
+ * encloses the orbits the kernels compute in double (or finer). Once a ball lies entirely outside the escape radius
+ * (while all before it were entirely inside) every point escapes in that iteration. The ball is saved (with twice its
+ * radius) at iterations 1, 2, 4, 8, ...; a later ball inside the saved one means the enclosures cycle and no point ever
+ * escapes.
+ *
+ * @param escapeIteration Receives the iteration every point escapes in (same numbering as `calcMandel`), only for `Escaped`
+ */
+TileProof proveDisk(double centerReal, double centerImag, double radius, unsigned int maxIterations, std::uint32_t& escapeIteration);
+
+#endif
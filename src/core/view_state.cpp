@@ -0,0 +1,133 @@
+#include "view_state.h"
+
+#include <algorithm>
+#include <cmath>
+
+ComplexNum ViewState::pointAt(int x, int y) const {
+    // gl_FragCoord points at the pixel center and the shader adds another half pixel on top of that
+    long double fragX = static_cast<long double>(x + panX) + 0.5L;
+    long double fragY = static_cast<long double>(height - 1 - y - panY) + 0.5L;
+
+    long double real = zoomScale * (fragX + 0.5L) / width + realPartStart.toLongDouble();
+    long double imag = (zoomScale * (fragY + 0.5L) + imagPartStart.toLongDouble() * height) / width;
+    return {real, imag};
+}
+
+int ViewState::calcRequiredFractionLimbs(long double zoomScale, int width) {
+    // The coordinates have to resolve the pixel spacing, plus guard bits for the rounding errors of long orbits
+    constexpr int GUARD_BITS = 64;
+    long double spacing = zoomScale / width;
+    int spacingBits = spacing > 0.0L ? static_cast<int>(std::ceil(-std::log2(spacing))) : 0;
+    return BigFixed::limbsForBits(std::max(0, spacingBits) + GUARD_BITS);
+}
+
+ComplexFixed ViewState::center() const {
+    // real = realPartStart + zoomScale / 2, imag = (imagPartStart * height + zoomScale * height / 2) / width
+    int fractionLimbs = requiredFractionLimbs();
+    auto unsignedWidth = static_cast<std::uint32_t>(width);
+    auto unsignedHeight = static_cast<std::uint32_t>(height);
+    BigFixed zoom{zoomScale, fractionLimbs};
+    BigFixed real = realPartStart.withPrecision(fractionLimbs) + zoom.scaledByPowerOfTwo(-1);
+    BigFixed imag = (imagPartStart.withPrecision(fractionLimbs).multipliedBy(unsignedHeight) + zoom.multipliedBy(unsignedHeight).scaledByPowerOfTwo(-1))
+        .dividedBy(unsignedWidth);
+    if (panX == 0 && panY == 0)
+        return {real, imag};
+    long double panReal = zoomScale * static_cast<long double>(panX) / width;
+    long double panImag = zoomScale * static_cast<long double>(panY) / width;
+    return {real + BigFixed{panReal, fractionLimbs}, imag - BigFixed{panImag, fractionLimbs}};
+}
+
+void ViewState::setCenter(const ComplexFixed& point) {
+    // Inverse of center(): realPartStart = real - zoomScale / 2, imagPartStart = (imag * width - zoomScale * height / 2) / height
+    int fractionLimbs = requiredFractionLimbs();
+    auto unsignedWidth = static_cast<std::uint32_t>(width);
+    auto unsignedHeight = static_cast<std::uint32_t>(height);
+    BigFixed zoom{zoomScale, fractionLimbs};
+    realPartStart = point.real.withPrecision(fractionLimbs) - zoom.scaledByPowerOfTwo(-1);
+    imagPartStart = (point.imag.withPrecision(fractionLimbs).multipliedBy(unsignedWidth) - zoom.multipliedBy(unsignedHeight).scaledByPowerOfTwo(-1))
+        .dividedBy(unsignedHeight);
+    panX = 0;
+    panY = 0;
+}
+
+ComplexNum ViewState::offsetFromCenter(int x, int y) const {
+    long double real = zoomScale * ((x + 1) - 0.5L * width) / width;
+    long double imag = zoomScale * (0.5L * height - y) / width;
+    return {real, imag};
+}
+
+ComplexFixed ViewState::latticeOrigin() const {
+    // Rounded the same way for every zoom, or the lattices of different zooms would not meet
+    int fractionLimbs = latticeFractionLimbs();
+    BigFixed imag = imagPartStart.withPrecision(fractionLimbs).multipliedBy(static_cast<std::uint32_t>(height)).dividedBy(static_cast<std::uint32_t>(width));
+    return {realPartStart.withPrecision(fractionLimbs), imag};
+}
+
+int ViewState::latticeFractionLimbs() const {
+    return std::max({realPartStart.getFractionLimbs(), imagPartStart.getFractionLimbs(), requiredFractionLimbs()});
+}
+
+ComplexNum ViewState::offsetFromLatticeOrigin(int x, int y) const {
+    // Same products as pointAt(), scaling zoomScale and the index by inverse powers of two gives the same result
+    long double real = zoomScale * static_cast<long double>(x + panX + 1) / width;
+    long double imag = zoomScale * static_cast<long double>(height - y - panY) / width;
+    return {real, imag};
+}
+
+void ViewState::applyPan() {
+    // imag = (imagPartStart * height + zoomScale * (height - y - panY)) / width, so panY moves imagPartStart by zoomScale * panY / height
+    int fractionLimbs = requiredFractionLimbs();
+    realPartStart = realPartStart.withPrecision(fractionLimbs) + BigFixed{zoomScale * static_cast<long double>(panX) / width, fractionLimbs};
+    imagPartStart = imagPartStart.withPrecision(fractionLimbs) - BigFixed{zoomScale * static_cast<long double>(panY) / height, fractionLimbs};
+    panX = 0;
+    panY = 0;
+}
+
+long double ViewState::radius() const {
+    // The corners are the pixels farthest from the center
+    ComplexNum corner = offsetFromCenter(0, 0);
+    ComplexNum oppositeCorner = offsetFromCenter(width - 1, height - 1);
+    return std::hypot(std::max(std::fabs(corner.first), std::fabs(oppositeCorner.first)),
+        std::max(std::fabs(corner.second), std::fabs(oppositeCorner.second)));
+}
+
+bool ViewState::isPrecisionSufficient(int mantissaBits) const {
+    // A pixel has to span about 1000 ulps, the iteration amplifies the rounding errors of the start point
+    long double minRelativeSpacing = std::ldexp(1.0L, 11 - mantissaBits);
+    ComplexNum middle = pointAt(width / 2, height / 2);
+    long double magnitude = std::max({1.0L, std::fabs(middle.first), std::fabs(middle.second)});
+    return pixelSpacing() >= magnitude * minRelativeSpacing;
+}
+
+ShaderPrecision ViewState::cheapestShaderPrecision() const {
+    if (isPrecisionSufficient(24))
+        return ShaderPrecision::Float;
+    if (isPrecisionSufficient(48))
+        return ShaderPrecision::DoubleSingle;
+    if (isDoublePrecisionSufficient())
+        return ShaderPrecision::Double;
+    return ShaderPrecision::DoubleDouble;
+}
+
+const char* shaderPrecisionName(ShaderPrecision precision) {
+    switch (precision) {
+        case ShaderPrecision::Float:
+            return "float";
+        case ShaderPrecision::DoubleSingle:
+            return "double-single";
+        case ShaderPrecision::Double:
+            return "double";
+        case ShaderPrecision::DoubleDouble:
+            return "double-double";
+    }
+    return "unknown";
+}
+
+unsigned int calcAutoMaxIterations(long double zoomScale) {
+    long double iterations = 400.0L + 100.0L * -std::log10(zoomScale);
+    if (iterations < 200.0L)
+        return 200;
+    if (iterations > 4000.0L)
+        return 4000;
+    return static_cast<unsigned int>(iterations);
+}
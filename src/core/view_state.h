@@ -0,0 +1,149 @@
+#pragma once
+#ifndef MANDELBROT_VIEWSTATE_INCLUDED
+#define MANDELBROT_VIEWSTATE_INCLUDED
+
+#include <cstdint>
+#include <limits>
+
+#include "../app_utility.h"
+#include "big_fixed.h"
+
+/**
+ * Number formats `res/fragment_shader.glsl` can iterate in, cheapest first
+ */
+enum class ShaderPrecision {
+    Float = 0,        // 24 bit mantissa, full rate on every GPU
+    DoubleSingle = 1, // Unevaluated sum of two floats, about 48 bits from a dozen float operations per operation
+    Double = 2,       // 53 bits, 1/16 to 1/64 of the float rate on most consumer GPUs and in software GL
+    DoubleDouble = 3, // Unevaluated sum of two doubles, about 106 bits
+};
+
+const char* shaderPrecisionName(ShaderPrecision precision);
+
+/**
+ * Everything needed to compute one frame, mirroring the uniforms of `res/fragment_shader.glsl`
+ *
+ * `realPartStart` and `imagPartStart` use the same (slightly unusual) convention as `main.cpp`:
+ * the imaginary start is scaled by `height / width` when mapping a pixel to the complex plane.
+ * They are `BigFixed`, so the view can be placed anywhere no matter how small `zoomScale` gets,
+ * `requiredFractionLimbs` tells how much precision that takes.
+ *
+ * Dragging the view moves it by whole pixels, `panX` and `panY` count them without touching the start values: the
+ * pixels of every panned view then lie on the same lattice, and a pixel keeps bit-identical coordinates while the view
+ * moves. `applyPan` moves the pan into the start values once the lattice is not needed anymore (e.g. before zooming).
+ * Pixel n of the lattice (counted from `latticeOrigin()`) is at `n * zoomScale / width`, so views whose `zoomScale`
+ * differs by a power of two also share the points where their lattices meet.
+ */
+struct ViewState {
+    long double zoomScale = 3.5L;
+    BigFixed realPartStart{-2.5L, 2};
+    BigFixed imagPartStart{-1.75L, 2};
+    int width = 1080;
+    int height = 720;
+    unsigned int maxIterations = 300;
+    std::int64_t panX = 0; // Pixels the view is moved to the right of the start values
+    std::int64_t panY = 0; // Pixels the view is moved down from the start values
+
+    /**
+     * Maps a pixel to the complex plane exactly like the `main()` of the fragment shader does
+     *
+     * @param x Column of the pixel, 0 is the left edge
+     * @param y Row of the pixel, 0 is the top edge (unlike `gl_FragCoord`, which starts at the bottom)
+     */
+    ComplexNum pointAt(int x, int y) const;
+
+    /**
+     * @return The distance between two neighbouring pixels in the complex plane
+     */
+    inline long double pixelSpacing() const { return zoomScale / width; }
+
+    /**
+     * @return The number of `BigFixed` fraction limbs coordinates and reference orbits of this view need
+     */
+    inline int requiredFractionLimbs() const { return calcRequiredFractionLimbs(zoomScale, width); }
+
+    /**
+     * @return The number of `BigFixed` fraction limbs to resolve the pixels of a view, plus guard bits
+     */
+    static int calcRequiredFractionLimbs(long double zoomScale, int width);
+
+    /**
+     * @return The point perturbation frames use as reference, the middle of the view
+     */
+    ComplexFixed center() const;
+
+    /**
+     * Moves the view so that `center()` is `point`, the zoom stays and the pan is reset
+     */
+    void setCenter(const ComplexFixed& point);
+
+    /**
+     * @return The offset of the pixel `pointAt(x, y)` to `center()`, accurate even when the pixel spacing is tiny
+     */
+    ComplexNum offsetFromCenter(int x, int y) const;
+
+    /**
+     * @return The point the pixel lattice counts from: `realPartStart` and `imagPartStart * height / width`, neither the pan nor the zoom moves it
+     */
+    ComplexFixed latticeOrigin() const;
+
+    /**
+     * @return The number of fraction limbs of `latticeOrigin()`, at least those of the start values
+     */
+    int latticeFractionLimbs() const;
+
+    /**
+     * @return The offset of the pixel `pointAt(x, y)` to `latticeOrigin()`, the same for the same point in every view on the lattice
+     */
+    ComplexNum offsetFromLatticeOrigin(int x, int y) const;
+
+    /**
+     * Adds the pan to the start values and resets it, the view stays where it is
+     */
+    void applyPan();
+
+    /**
+     * @return The distance from `center()` to the farthest pixel
+     */
+    long double radius() const;
+
+    /**
+     * @param mantissaBits Precision of the number format, including the implicit bit
+     * @return Whether pixel coordinates with that precision still resolve neighbouring pixels of this view
+     */
+    bool isPrecisionSufficient(int mantissaBits) const;
+
+    /**
+     * @return Whether `double` pixel coordinates still resolve neighbouring pixels of this view
+     */
+    inline bool isDoublePrecisionSufficient() const { return isPrecisionSufficient(53); }
+
+    /**
+     * @return Whether double-double pixel coordinates (about 106 bits) still resolve neighbouring pixels of this view
+     */
+    inline bool isDoubleDoublePrecisionSufficient() const { return isPrecisionSufficient(106); }
+
+    /**
+     * @return The cheapest shader precision that resolves the pixels of this view, `DoubleDouble` if none does
+     */
+    ShaderPrecision cheapestShaderPrecision() const;
+
+    inline std::size_t pixelCount() const { return static_cast<std::size_t>(width) * static_cast<std::size_t>(height); }
+
+    bool operator==(const ViewState& other) const = default;
+};
+
+/**
+ * Smallest `zoomScale` a view can have. The zoom and the pixel offsets are `long double`, which has a 15 bit exponent with
+ * GCC and Clang on x86 (views down to about 1e-4900), but is plain `double` with MSVC and on most other targets (about
+ * 1e-284). Deeper views would silently underflow to 0 there, so the app and the CLI refuse them; the margin keeps
+ * `pixelSpacing()` and the offsets of every pixel normal numbers.
+ */
+constexpr long double MIN_ZOOM_SCALE = std::numeric_limits<long double>::min() * 0x1p80L;
+
+/**
+ * Iteration limit the app uses when "auto max iterations" is enabled
+ */
+unsigned int calcAutoMaxIterations(long double zoomScale);
+
+#endif
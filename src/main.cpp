@@ -7,6 +7,9 @@
 #include <tuple>
 #include <vector>
 #include <thread>
+#include <future>
+#include <mutex>
+#include <algorithm>
 
 #include <ImGui/imgui.h>
 #include <ImGui/imgui_impl_glfw.h>
@@ -17,16 +20,29 @@
 #include "app_utility.h"
 #include "shader.h"
 #include "saved_view.h"
+#include "core/view_state.h"
+#include "core/render_engine.h"
+#include "core/nucleus_finder.h"
+#include "core/double_double.h"
 
 #define IMGUI_IMPL_OPENGL_LOADER_GLAD2
 
 static GLFWwindow* window;
-static Shader shader;
+static std::array<Shader, 4> precisionShaders; // Indexed by ShaderPrecision, the fragment shader with GPU_PRECISION set to the index
+static Shader iterationShader; // Same fragment shader, but colors the iteration counts computed by the CPU engine
+static int shaderPrecisionSetting = 0; // 0 picks the cheapest precision that resolves the view, else the ShaderPrecision plus 1
 static int windowWidth = 1080;
 static int windowHeight = 720;
 static long double zoomScale = 3.5L; //1.7e-10;
-static long double realPartStart = -2.5L; //-0.04144230656908739;
-static long double imagPartStart = -1.75L; //1.48014290228390966;
+static BigFixed realPartStart{-2.5L, 2}; //-0.04144230656908739;
+static BigFixed imagPartStart{-1.75L, 2}; //1.48014290228390966;
+static std::int64_t panX = 0; // Whole pixels the view was dragged by, see ViewState::panX
+static std::int64_t panY = 0;
+static bool dyadicZoom = false; // CPU frames are rendered at the nearest power-of-two zoom and shown scaled, see getCpuViewState
+static ViewState dyadicLattice; // Start values, size and precision of the lattice of the dyadic frames
+static bool dragging = false;
+static double dragCursorX = 0.0; // Cursor position the pan so far corresponds to
+static double dragCursorY = 0.0;
 static constexpr long double ZOOM_STEP = 1.1L;
 
 static std::array<float, 25> lastFrameDeltas;
@@ -35,19 +51,28 @@ static bool autoMaxIterations = true;
 static int maxIterations = 300;
 static bool ImGuiEnabled = true;
 
+static bool cpuRendering = false;
+static RenderEngine cpuEngine;
+static std::future<void> cpuFrame; // Frame the engine is working on in the background
+static ViewState cpuFrameView; // View of `cpuFrame`, or of the last finished frame
+static IterationBuffer cpuFrameBuffer; // Written by the engine's workers, a tile may only be read while it is being reported
+static RenderStatistics cpuFrameStatistics;
+static std::mutex finishedTilesMutex;
+static std::vector<TileReport> finishedTiles;
+// Pixels of `finishedTiles`, copied when they are reported: progressive frames write the tiles again on the next level
+static IterationBuffer finishedTilesBuffer;
+static unsigned int iterationTexture;
+static int iterationTextureWidth = 0;
+static int iterationTextureHeight = 0;
+
 
 // * HELPER FUNCTIONS
 
 static int getMaxIterations() {
 	//int zoomCount = -std::log(zoomScale / 3.5) / std::log(ZOOM_STEP); // how often you have zoomed in
 
-	if (autoMaxIterations) {
-		maxIterations = 400 + 100L * -std::log10(zoomScale);
-		if (maxIterations < 200)
-			maxIterations = 200;
-		else if (maxIterations > 4000)
-			maxIterations = 4000;
-	}
+	if (autoMaxIterations)
+		maxIterations = calcAutoMaxIterations(zoomScale);
 	return maxIterations;
 }
 
@@ -58,9 +83,39 @@ static float calcFPSAverage() {
 	return average / lastFrameDeltas.size();
 }
 
+static ViewState getViewState() {
+	ViewState view;
+	view.zoomScale = zoomScale;
+	view.realPartStart = realPartStart;
+	view.imagPartStart = imagPartStart;
+	view.panX = panX;
+	view.panY = panY;
+	view.width = windowWidth;
+	view.height = windowHeight;
+	view.maxIterations = static_cast<unsigned int>(getMaxIterations());
+	return view;
+}
+
+/**
+ * @return The number of `BigFixed` fraction limbs the view coordinates need at `zoomScale`
+ */
+static int getFractionLimbs() {
+	return ViewState::calcRequiredFractionLimbs(zoomScale, windowWidth);
+}
+
+/**
+ * @return The current view with its pan moved into the start values
+ */
+static ViewState getAppliedViewState() {
+	ViewState view = getViewState();
+	view.applyPan();
+	return view;
+}
+
 static ComplexNum getNumberAtPos(double x, double y) {
-	long double real = zoomScale * (x + 0.5) / windowWidth + realPartStart;
-    long double imag = (zoomScale * (y + 0.5) + imagPartStart * windowHeight) / windowWidth;
+	ViewState view = getAppliedViewState();
+	long double real = zoomScale * (x + 0.5) / windowWidth + view.realPartStart.toLongDouble();
+    long double imag = (zoomScale * (y + 0.5) + view.imagPartStart.toLongDouble() * windowHeight) / windowWidth;
 
 	return {real, imag};
 }
@@ -71,22 +126,250 @@ static ComplexNum getNumberAtCursor() {
 	return getNumberAtPos(mouseX, mouseY);
 }
 
+// Lattice indices of dyadic frames grow by a factor of two per zoom step, the lattice moves to the view before they get imprecise
+static constexpr long double MAX_DYADIC_INDEX = 0x1p40L;
+
+/**
+ * @return The view the CPU engine renders: the current one, or with `dyadicZoom` the nearest view whose pixel spacing is a
+ * power of two, on a lattice that stays the same while zooming, so the engine can reuse the points frames share
+ */
+static ViewState getCpuViewState() {
+	ViewState view = getViewState();
+	if (!dyadicZoom)
+		return view;
+
+	ViewState dyadic = view;
+	int level = static_cast<int>(std::lround(std::log2(view.pixelSpacing())));
+	dyadic.zoomScale = std::ldexp(static_cast<long double>(view.width), level);
+	if (autoMaxIterations) // Only changes with the level, every scroll step would otherwise give the frame a new limit
+		dyadic.maxIterations = calcAutoMaxIterations(dyadic.zoomScale);
+
+	// The center pixel is the lattice point nearest to the center of the view
+	ComplexFixed center = view.center();
+	auto latticeIndex = [&](ComplexNum& index) {
+		dyadic.realPartStart = dyadicLattice.realPartStart;
+		dyadic.imagPartStart = dyadicLattice.imagPartStart;
+		dyadic.panX = 0;
+		dyadic.panY = 0;
+		ComplexFixed origin = dyadic.latticeOrigin();
+		index = {std::ldexp((center.real - origin.real).toLongDouble(), -level), std::ldexp((center.imag - origin.imag).toLongDouble(), -level)};
+		return std::fabs(index.first) < MAX_DYADIC_INDEX && std::fabs(index.second) < MAX_DYADIC_INDEX;
+	};
+	ComplexNum index;
+	if (dyadicLattice.width != view.width || dyadicLattice.height != view.height
+		|| std::min(dyadicLattice.realPartStart.getFractionLimbs(), dyadicLattice.imagPartStart.getFractionLimbs()) < dyadic.requiredFractionLimbs()
+		|| !latticeIndex(index)) {
+		// A new lattice at the view, with a limb to spare so it lasts for the next 32 zoom levels
+		ViewState applied = getAppliedViewState();
+		int fractionLimbs = dyadic.requiredFractionLimbs() + 1;
+		dyadicLattice = view;
+		dyadicLattice.realPartStart = applied.realPartStart.withPrecision(fractionLimbs);
+		dyadicLattice.imagPartStart = applied.imagPartStart.withPrecision(fractionLimbs);
+		latticeIndex(index);
+	}
+	// Column x is lattice index x + panX + 1 and row y index height - y - panY
+	dyadic.panX = static_cast<std::int64_t>(std::llround(index.first)) - view.width / 2 - 1;
+	dyadic.panY = view.height - view.height / 2 - static_cast<std::int64_t>(std::llround(index.second));
+	return dyadic;
+}
+
+/**
+ * @return The part of the iteration texture (left, top, width, height) that shows the current view, the texture holds `cpuFrameView`
+ */
+static std::array<float, 4> getIterationTextureArea() {
+	ViewState view = getViewState();
+	if (!dyadicZoom || cpuFrameView.width != view.width || cpuFrameView.height != view.height)
+		return {0.0f, 0.0f, 1.0f, 1.0f};
+	long double scale = view.zoomScale / cpuFrameView.zoomScale;
+	ComplexFixed center = view.center();
+	ComplexFixed frameCenter = cpuFrameView.center();
+	long double frameHeight = cpuFrameView.zoomScale * cpuFrameView.height / cpuFrameView.width;
+	long double centerX = 0.5L + (center.real - frameCenter.real).toLongDouble() / cpuFrameView.zoomScale;
+	long double centerY = 0.5L - (center.imag - frameCenter.imag).toLongDouble() / frameHeight;
+	return {static_cast<float>(centerX - 0.5L * scale), static_cast<float>(centerY - 0.5L * scale), static_cast<float>(scale), static_cast<float>(scale)};
+}
+
 // * FUNCTIONS
 
+/**
+ * Moves the pan into the start values, the pixel lattice of the dragged view is not kept after this
+ */
+static void applyPan() {
+	ViewState view = getAppliedViewState();
+	realPartStart = view.realPartStart;
+	imagPartStart = view.imagPartStart;
+	panX = 0;
+	panY = 0;
+}
+
+/**
+ * Drags the view with the left mouse button, by whole pixels so the CPU engine can reuse the pixels of the frame before
+ */
+static void updateDrag() {
+	if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS) {
+		dragging = false;
+		return;
+	}
+	double mouseX, mouseY;
+	glfwGetCursorPos(window, &mouseX, &mouseY);
+	if (!dragging) {
+		// Drags that start on the ImGui window move the window instead
+		if (ImGuiEnabled && ImGui::GetIO().WantCaptureMouse)
+			return;
+		dragging = true;
+		dragCursorX = mouseX;
+		dragCursorY = mouseY;
+		return;
+	}
+
+	// The fraction of a pixel stays in the drag until it adds up to a whole one
+	auto movedX = static_cast<std::int64_t>(std::floor(mouseX - dragCursorX));
+	auto movedY = static_cast<std::int64_t>(std::floor(mouseY - dragCursorY));
+	panX -= movedX;
+	panY -= movedY;
+	dragCursorX += static_cast<double>(movedX);
+	dragCursorY += static_cast<double>(movedY);
+}
+
 static void zoom(long double factor) {
+	applyPan();
+	if (zoomScale * factor < MIN_ZOOM_SCALE)
+		return; // As deep as long double reaches on this platform
+
 	double mouseX, mouseY;
 	glfwGetCursorPos(window, &mouseX, &mouseY);
 
-	realPartStart += (1.0L - factor) * zoomScale / windowWidth * mouseX;
-	imagPartStart += (1.0L - factor) * zoomScale / windowHeight * ((long double)windowHeight - mouseY);
+	// The offsets are tiny compared to the start values, so they are exact enough as long double
+	int fractionLimbs = ViewState::calcRequiredFractionLimbs(zoomScale * factor, windowWidth);
+	realPartStart = realPartStart.withPrecision(fractionLimbs) + BigFixed{(1.0L - factor) * zoomScale / windowWidth * mouseX, fractionLimbs};
+	imagPartStart = imagPartStart.withPrecision(fractionLimbs) + BigFixed{(1.0L - factor) * zoomScale / windowHeight * ((long double)windowHeight - mouseY), fractionLimbs};
 
 	zoomScale *= factor;
 }
 
+/**
+ * @return The precision the GPU renders the current view with
+ */
+static ShaderPrecision getShaderPrecision() {
+	if (shaderPrecisionSetting > 0)
+		return static_cast<ShaderPrecision>(shaderPrecisionSetting - 1);
+	return getViewState().cheapestShaderPrecision();
+}
+
+/**
+ * Uploads the tiles the CPU engine finished since the last call, and starts a new frame once the view changed
+ * Tiles of the previous view that are not started yet get dropped, the ones around the cursor are computed first.
+ */
+static void updateCpuFrame() {
+	ViewState view = getCpuViewState();
+	if (cpuFrame.valid() && view != cpuFrameView)
+		cpuEngine.advanceEpoch();
+
+	if (cpuFrame.valid() && cpuFrame.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		cpuFrame.get(); // No more tiles of this frame get reported after this
+		cpuFrameStatistics = cpuEngine.getLastStatistics();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{finishedTilesMutex};
+		glBindTexture(GL_TEXTURE_2D, iterationTexture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, finishedTilesBuffer.width);
+		for (const TileReport& tile : finishedTiles)
+			glTexSubImage2D(GL_TEXTURE_2D, 0, tile.x, tile.y, tile.width, tile.height, GL_RED_INTEGER, GL_UNSIGNED_INT, &finishedTilesBuffer.at(tile.x, tile.y));
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		finishedTiles.clear();
+	}
+
+	if (!cpuFrame.valid() && view != cpuFrameView) {
+		cpuFrameView = view;
+		cpuFrameBuffer = IterationBuffer{view.width, view.height};
+		finishedTilesBuffer = IterationBuffer{view.width, view.height};
+
+		// Until the new tiles arrive the texture keeps showing the previous frame, unless the size changed
+		if (view.width != iterationTextureWidth || view.height != iterationTextureHeight) {
+			glBindTexture(GL_TEXTURE_2D, iterationTexture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, view.width, view.height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+			iterationTextureWidth = view.width;
+			iterationTextureHeight = view.height;
+		}
+
+		FrameRequest request;
+		double mouseX, mouseY;
+		glfwGetCursorPos(window, &mouseX, &mouseY);
+		if (mouseX >= 0.0 && mouseY >= 0.0 && mouseX < view.width && mouseY < view.height) {
+			request.focusX = static_cast<int>(mouseX);
+			request.focusY = static_cast<int>(mouseY);
+		}
+		request.onTileDone = [](const TileReport& tile) {
+			std::lock_guard<std::mutex> lock{finishedTilesMutex};
+			for (int y = tile.y; y < tile.y + tile.height; y++)
+				std::copy_n(&cpuFrameBuffer.at(tile.x, y), tile.width, &finishedTilesBuffer.at(tile.x, y));
+			finishedTiles.push_back(tile);
+		};
+		cpuFrame = std::async(std::launch::async, [view, request] { cpuEngine.render(view, cpuFrameBuffer, request); });
+	}
+}
+
+/**
+ * Applies new engine settings, the frame in flight is cancelled and the view gets rendered again
+ */
+static void setCpuSettings(const RenderSettings& settings) {
+	if (cpuFrame.valid()) {
+		cpuEngine.advanceEpoch();
+		cpuFrame.get();
+	}
+	cpuEngine.setSettings(settings);
+	cpuFrameView.width = 0; // No window has that size, so the next update starts a new frame
+}
+
+static void setColor(int colorNumber) {
+	for (Shader& shader : precisionShaders)
+		shader.mandelRecompileWithColor(colorNumber);
+	iterationShader.mandelRecompileWithColor(colorNumber);
+
+	// Black/white only shows membership, so the distance fill of the CPU engine may fill the exterior disks too
+	bool membershipOnly = colorNumber == static_cast<int>(FlowColorType::BlackWhite);
+	if (cpuEngine.getSettings().membershipOnly != membershipOnly) {
+		RenderSettings settings = cpuEngine.getSettings();
+		settings.membershipOnly = membershipOnly;
+		setCpuSettings(settings);
+	}
+}
+
 static void jumpToView(const SavedView& savedView) {
+	if (savedView.getZoomScale() < MIN_ZOOM_SCALE) {
+		std::cout << "The view is deeper than long double reaches on this platform: " << savedView.getName() << std::endl;
+		return;
+	}
 	zoomScale = savedView.getZoomScale();
-	realPartStart = savedView.getStartNum().first;
-	imagPartStart = savedView.getStartNum().second;
+	realPartStart = savedView.getStartNum().real;
+	imagPartStart = savedView.getStartNum().imag;
+	panX = 0;
+	panY = 0;
+}
+
+/**
+ * Centers the view on the nucleus of the largest minibrot in view, or of the nearest one around it, the zoom stays
+ * @return The period of the minibrot, 0 if none was found
+ */
+static unsigned int jumpToNearestMinibrot() {
+	ViewState view = getViewState();
+	ComplexFixed center = view.center();
+	Nucleus nucleus;
+	// Wider searches reach farther, but find larger minibrots (lower periods)
+	long double radius = view.radius();
+	for (int attempt = 0; attempt < 8; attempt++, radius *= 4.0L) {
+		if (findNucleus(center, radius, view.maxIterations, nucleus)) {
+			view.setCenter(nucleus.center);
+			realPartStart = view.realPartStart;
+			imagPartStart = view.imagPartStart;
+			panX = 0;
+			panY = 0;
+			return nucleus.period;
+		}
+	}
+	return 0;
 }
 
 static void ImGuiFrame(bool& showImGuiWindow) {
@@ -108,13 +391,112 @@ static void ImGuiFrame(bool& showImGuiWindow) {
 				ImGui::Text("Color: ");
 				ImGui::SameLine();
 				if (ImGui::SmallButton("RGB"))
-					shader.mandelRecompileWithColor(0);
+					setColor(0);
 				ImGui::SameLine();
 				if (ImGui::SmallButton("Black/White"))
-					shader.mandelRecompileWithColor(1);
+					setColor(1);
 				ImGui::SameLine();
 				if (ImGui::SmallButton("Glowing"))
-					shader.mandelRecompileWithColor(2);
+					setColor(2);
+
+				ImGui::Text("Renderer: ");
+				ImGui::SameLine();
+				if (ImGui::RadioButton("GPU", !cpuRendering))
+					cpuRendering = false;
+				ImGui::SameLine();
+				if (ImGui::RadioButton("CPU", cpuRendering))
+					cpuRendering = true;
+				if (cpuRendering) {
+					ImGui::Text("CPU: %s %s, %u threads, %zu tiles", isaName(cpuFrameStatistics.isa), kernelModeName(cpuFrameStatistics.kernelMode),
+						cpuFrameStatistics.threadCount, cpuFrameStatistics.tileCount);
+					ImGui::Text("%.1f ms/frame, %.0f Miter/s", cpuFrameStatistics.seconds * 1000.0, cpuFrameStatistics.megaIterationsPerSecond());
+					ImGui::Text("Dropped stale tiles: %zu", cpuFrameStatistics.droppedTiles);
+					static const char* algorithmNames[] = {"Auto", "Direct", "Perturbation", "Perturbation + BLA", "Double-double", "Fixed point"};
+					int algorithm = static_cast<int>(cpuEngine.getSettings().algorithm);
+					if (ImGui::Combo("Algorithm", &algorithm, algorithmNames, IM_ARRAYSIZE(algorithmNames))) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.algorithm = static_cast<RenderAlgorithm>(algorithm);
+						setCpuSettings(settings);
+					}
+					bool nucleusReference = cpuEngine.getSettings().nucleusReference;
+					if (ImGui::Checkbox("Minibrot nucleus as reference", &nucleusReference)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.nucleusReference = nucleusReference;
+						setCpuSettings(settings);
+					}
+					bool rectangleSubdivision = cpuEngine.getSettings().rectangleSubdivision;
+					if (ImGui::Checkbox("Rectangle subdivision", &rectangleSubdivision)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.rectangleSubdivision = rectangleSubdivision;
+						setCpuSettings(settings);
+					}
+					if (cpuEngine.getSettings().rectangleSubdivision)
+						ImGui::Text("Filled without iterating: %zu pixels", cpuFrameStatistics.filledPixels);
+					bool provenTiles = cpuEngine.getSettings().provenTiles;
+					if (ImGui::Checkbox("Proven tiles (ball arithmetic)", &provenTiles)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.provenTiles = provenTiles;
+						setCpuSettings(settings);
+					}
+					if (cpuEngine.getSettings().provenTiles) {
+						double framePixels = static_cast<double>(cpuFrameView.width) * static_cast<double>(cpuFrameView.height);
+						ImGui::Text("Proven: %.1f%% of the pixels", framePixels > 0.0 ? 100.0 * static_cast<double>(cpuFrameStatistics.provenPixels) / framePixels : 0.0);
+					}
+					bool distanceFill = cpuEngine.getSettings().distanceFill;
+					if (ImGui::Checkbox("Distance estimate fill (exterior too with black/white)", &distanceFill)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.distanceFill = distanceFill;
+						setCpuSettings(settings);
+					}
+					if (cpuEngine.getSettings().distanceFill) {
+						double framePixels = static_cast<double>(cpuFrameView.width) * static_cast<double>(cpuFrameView.height);
+						ImGui::Text("Skipped: %.1f%% of the pixels", framePixels > 0.0 ? 100.0 * static_cast<double>(cpuFrameStatistics.distancePixels) / framePixels : 0.0);
+					}
+					bool progressiveRefinement = cpuEngine.getSettings().progressiveRefinement;
+					if (ImGui::Checkbox("Progressive refinement", &progressiveRefinement)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.progressiveRefinement = progressiveRefinement;
+						setCpuSettings(settings);
+					}
+					if (cpuEngine.getSettings().progressiveRefinement)
+						ImGui::Text("Guessed from neighbours: %zu pixels", cpuFrameStatistics.guessedPixels);
+					bool reusePixels = cpuEngine.getSettings().reusePixels;
+					if (ImGui::Checkbox("Reuse pixels of the frame before", &reusePixels)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.reusePixels = reusePixels;
+						setCpuSettings(settings);
+					}
+					if (cpuEngine.getSettings().reusePixels) {
+						ImGui::Text("Reused: %zu pixels", cpuFrameStatistics.reusedPixels);
+						ImGui::Checkbox("Dyadic zoom (power-of-two frames, scaled in between)", &dyadicZoom);
+					}
+					ImGui::Text("Used: %s", renderAlgorithmName(cpuFrameStatistics.algorithm));
+					if (cpuFrameStatistics.algorithm == RenderAlgorithm::Direct)
+						ImGui::Text("Interior: %zu in cardioid/bulb, %zu periodic", cpuFrameStatistics.bulbPixels, cpuFrameStatistics.periodicPixels);
+					if (cpuFrameStatistics.algorithm == RenderAlgorithm::FixedPoint)
+						ImGui::Text("Fixed point: %u bit integers", cpuFrameStatistics.fixedPointBits);
+					if (cpuFrameStatistics.algorithm == RenderAlgorithm::Perturbation || cpuFrameStatistics.algorithm == RenderAlgorithm::Bla) {
+						if (cpuFrameStatistics.referenceReused)
+							ImGui::Text("Reference orbit: %zu iterations, reused", cpuFrameStatistics.referenceIterations);
+						else
+							ImGui::Text("Reference orbit: %zu iterations, %.1f ms", cpuFrameStatistics.referenceIterations, cpuFrameStatistics.referenceSeconds * 1000.0);
+						if (cpuFrameStatistics.referencePeriod > 0)
+							ImGui::Text("Reference: nucleus of period %u", cpuFrameStatistics.referencePeriod);
+						ImGui::Text("Reference memory: %zu KiB%s", cpuFrameStatistics.referenceBytes / 1024, cpuFrameStatistics.referenceCompressed ? ", compressed" : "");
+						ImGui::Text("Deltas: %s", cpuFrameStatistics.rescaledDeltas ? "double with separate exponent" : "double");
+						if (cpuFrameStatistics.algorithm == RenderAlgorithm::Perturbation) {
+							ImGui::Text("Glitches: %zu pixels, %u passes, %zu references, %zu left", cpuFrameStatistics.glitchedPixels,
+								cpuFrameStatistics.glitchPasses, cpuFrameStatistics.glitchReferences, cpuFrameStatistics.remainingGlitches);
+						}
+					}
+				}
+				else {
+					static const char* precisionNames[] = {"Auto", "Float", "Double-single", "Double", "Double-double"};
+					ImGui::Combo("Precision", &shaderPrecisionSetting, precisionNames, IM_ARRAYSIZE(precisionNames));
+					ImGui::Text("GPU precision: %s", shaderPrecisionName(getShaderPrecision()));
+					if (!getViewState().isDoubleDoublePrecisionSufficient())
+						ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "Too deep for the GPU, switch to CPU for perturbation");
+				}
 
 				//ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
 				ImGui::Text("%.1f fps", calcFPSAverage());
@@ -126,8 +508,18 @@ static void ImGuiFrame(bool& showImGuiWindow) {
 			if (ImGui::BeginTabItem("Saved views"))
 			{
 				// Button to save current view
-				if (ImGui::Button("Save current view"))
-					SavedView::saveNew(zoomScale, {realPartStart, imagPartStart});
+				if (ImGui::Button("Save current view")) {
+					ViewState view = getAppliedViewState();
+					SavedView::saveNew(zoomScale, {view.realPartStart, view.imagPartStart});
+				}
+				ImGui::SameLine();
+				static int minibrotPeriod = -1; // -1 before the first search
+				if (ImGui::Button("Jump to nearest minibrot"))
+					minibrotPeriod = static_cast<int>(jumpToNearestMinibrot());
+				if (minibrotPeriod > 0)
+					ImGui::Text("Centered on a minibrot of period %d", minibrotPeriod);
+				else if (minibrotPeriod == 0)
+					ImGui::Text("No minibrot found near the view");
 
 				for (SavedView& savedView : SavedView::allViews) {
 					ImGui::PushID(savedView.getImGuiIDs()[0]);
@@ -171,12 +563,39 @@ static void ImGuiFrame(bool& showImGuiWindow) {
 			}
 			if (ImGui::BeginTabItem("Advanced"))
 			{
-				ImGui::Text("Start real:\t%.25Lf", realPartStart);
-				ImGui::Text("Start imag:\t%.25Lf", imagPartStart);
+				ViewState appliedView = getAppliedViewState();
+				ImGui::Text("Start real:\t%s", appliedView.realPartStart.toString().c_str());
+				ImGui::Text("Start imag:\t%s", appliedView.imagPartStart.toString().c_str());
+				ImGui::Text("Precision:\t%d bits", 32 * getFractionLimbs());
+				if (cpuRendering && cpuFrameStatistics.algorithm == RenderAlgorithm::Perturbation) {
+					ImGui::Text("Series approximation: %u iterations skipped", cpuFrameStatistics.seriesSkippedIterations);
+					ImGui::Text("Series error bound:\t%.2e", cpuFrameStatistics.seriesErrorBound);
+				}
+				if (cpuRendering && cpuFrameStatistics.algorithm == RenderAlgorithm::Bla) {
+					for (std::size_t level = 0; level < cpuFrameStatistics.blaLevelBytes.size(); level++)
+						ImGui::Text("BLA level %zu (%llu steps):\t%.1f KiB", level, static_cast<unsigned long long>(std::uint64_t{1} << level),
+							static_cast<double>(cpuFrameStatistics.blaLevelBytes[level]) / 1024.0);
+				}
+				if (cpuRendering) {
+					int tileCacheMiB = static_cast<int>(cpuEngine.getSettings().tileCacheMemory >> 20);
+					if (ImGui::SliderInt("Tile cache (MiB)", &tileCacheMiB, 0, 4096)) {
+						RenderSettings settings = cpuEngine.getSettings();
+						settings.tileCacheMemory = static_cast<std::size_t>(tileCacheMiB) << 20;
+						setCpuSettings(settings);
+					}
+					if (cpuEngine.getSettings().tileCacheMemory > 0) {
+						const TileCacheStatistics& tileCache = cpuFrameStatistics.tileCache;
+						ImGui::Text("From the tile cache: %zu pixels", cpuFrameStatistics.cachedPixels);
+						ImGui::Text("Tile cache: %zu tiles, %.1f MiB", tileCache.tiles, static_cast<double>(tileCache.bytes) / (1024.0 * 1024.0));
+						ImGui::Text("Hits: %llu, misses: %llu, evictions: %llu", static_cast<unsigned long long>(tileCache.hits),
+							static_cast<unsigned long long>(tileCache.misses), static_cast<unsigned long long>(tileCache.evictions));
+					}
+				}
 				ImGui::EndTabItem();
 			}
 			if (ImGui::BeginTabItem("Help"))
 			{
+				ImGui::Text("Drag with the left mouse button to move the view");
 				ImGui::Text("Press Ctrl + Enter to toggle GUI");
 				ImGui::Text("Press Ctrl + Esc or Pause to exit the app");
 				ImGui::EndTabItem();
@@ -193,8 +612,13 @@ static void ImGuiFrame(bool& showImGuiWindow) {
 
 static void windowResizeCallback(GLFWwindow* window, int width, int height)
 {
-	realPartStart = (0.5l * zoomScale * (1.0l / windowWidth - 1.0l / width)) + realPartStart;
-	imagPartStart = ((long double)width / height) * ((zoomScale * (0.5l * windowHeight + 0.5l) + imagPartStart * windowHeight) / windowWidth) - (0.5l * zoomScale * (1.0l + 1.0l / height));
+	// Keeps the view centered, the start values are scaled as BigFixed so none of their digits get lost
+	applyPan();
+	int fractionLimbs = ViewState::calcRequiredFractionLimbs(zoomScale, width);
+	realPartStart = BigFixed{0.5l * zoomScale * (1.0l / windowWidth - 1.0l / width), fractionLimbs} + realPartStart.withPrecision(fractionLimbs);
+	imagPartStart = imagPartStart.withPrecision(fractionLimbs).multipliedBy(static_cast<std::uint32_t>(windowHeight) * static_cast<std::uint32_t>(width))
+		.dividedBy(static_cast<std::uint32_t>(windowWidth) * static_cast<std::uint32_t>(height))
+		+ BigFixed{((long double)width / height) * (zoomScale * (0.5l * windowHeight + 0.5l) / windowWidth) - (0.5l * zoomScale * (1.0l + 1.0l / height)), fractionLimbs};
 	windowWidth = width;
 	windowHeight = height;
 	glViewport(0, 0, width, height);
@@ -340,7 +764,32 @@ int main()
 		return -1;
 	initImGui();
 
-	shader = {AppRootDir + "res/vertex_shader.glsl", AppRootDir + "res/fragment_shader.glsl", true, false}; // Compile and link shader, but keep sources, ...
+	for (std::size_t precision = 0; precision < precisionShaders.size(); precision++) {
+		Shader& shader = precisionShaders[precision];
+		shader = {AppRootDir + "res/vertex_shader.glsl", AppRootDir + "res/fragment_shader.glsl", false, false}; // Keep sources, ...
+		shader.define("FLOW_COLOR_TYPE", "0");
+		shader.define("USE_ITERATION_TEXTURE", "0");
+		shader.define("GPU_PRECISION", std::to_string(precision));
+		shader.compileVertexShader();
+		shader.compileFragmentShader();
+		shader.link();
+	}
+
+	iterationShader = {AppRootDir + "res/vertex_shader.glsl", AppRootDir + "res/fragment_shader.glsl", false, false};
+	iterationShader.define("FLOW_COLOR_TYPE", "0");
+	iterationShader.define("USE_ITERATION_TEXTURE", "1");
+	iterationShader.define("GPU_PRECISION", "0");
+	iterationShader.compileVertexShader();
+	iterationShader.compileFragmentShader();
+	iterationShader.link();
+
+	// texture for the iteration counts of the CPU engine (integer textures can only use nearest filtering)
+	glGenTextures(1, &iterationTexture);
+	glBindTexture(GL_TEXTURE_2D, iterationTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 	float vertices[] = {
 		-1.0f, -1.0f,	// bottom left
@@ -392,13 +841,40 @@ int main()
 			ImGuiFrame(showImGuiWindow);
 		}
 
-		// use program
-		shader.use();
+		updateDrag();
 
-		shader.setVec2UInt("windowSize", windowWidth, windowHeight);
-		shader.setDouble("zoomScale", zoomScale);
-		shader.setVec2Double("numberStart", realPartStart, imagPartStart);
-		shader.setUInt("maxIterations", getMaxIterations());
+		// use program
+		if (cpuRendering) {
+			updateCpuFrame();
+			iterationShader.use();
+			iterationShader.setVec2UInt("windowSize", windowWidth, windowHeight);
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, iterationTexture);
+			iterationShader.setInt("iterationTexture", 0);
+			std::array<float, 4> area = getIterationTextureArea();
+			iterationShader.setVec4("iterationTextureArea", area[0], area[1], area[2], area[3]);
+		}
+		else {
+			ShaderPrecision precision = getShaderPrecision();
+			Shader& shader = precisionShaders[static_cast<std::size_t>(precision)];
+			shader.use();
+
+			shader.setVec2UInt("windowSize", windowWidth, windowHeight);
+			shader.setDouble("zoomScale", zoomScale);
+			if (precision == ShaderPrecision::DoubleDouble) {
+				// The start values in double would lose the low bits, the double-double variant adds offsets to the center
+				ComplexFixed center = getViewState().center();
+				DoubleDouble centerReal = DoubleDouble::fromBigFixed(center.real);
+				DoubleDouble centerImag = DoubleDouble::fromBigFixed(center.imag);
+				shader.setVec2Double("centerReal", centerReal.high, centerReal.low);
+				shader.setVec2Double("centerImag", centerImag.high, centerImag.low);
+			}
+			else {
+				ViewState view = getAppliedViewState();
+				shader.setVec2Double("numberStart", view.realPartStart.toDouble(), view.imagPartStart.toDouble());
+			}
+			shader.setUInt("maxIterations", getMaxIterations());
+		}
 	
 		if (ImGuiEnabled)
 			ImGui::Render();
@@ -432,11 +908,22 @@ int main()
 		}
 	}
 
+	// cancel the CPU engine's frame, its tiles that are not started yet get dropped
+	if (cpuFrame.valid()) {
+		cpuEngine.advanceEpoch();
+		cpuFrame.wait();
+	}
+
 	// delete al resources (not necessary)
 	glDeleteVertexArrays(1, &vertexArray);
 	glDeleteBuffers(1, &vertexBuffer);
-	shader.clean();
-	shader.deleteProgram();
+	glDeleteTextures(1, &iterationTexture);
+	for (Shader& shader : precisionShaders) {
+		shader.clean();
+		shader.deleteProgram();
+	}
+	iterationShader.clean();
+	iterationShader.deleteProgram();
 
 	ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "core/view_state.h"
+#include "core/render_engine.h"
+#include "core/image_writer.h"
+
+// Headless renderer, computes a single frame on the CPU and writes it to an image file
+
+struct CliOptions {
+	ViewState view;
+	bool autoIterations = true;
+	FlowColorType colorType = FlowColorType::Rgb;
+	std::string outputPath = "mandelbrot.png";
+	RenderSettings settings;
+	bool benchmark = false;
+	bool benchmarkAlgorithms = false;
+	bool checkSubdivision = false;
+	bool checkReuse = false;
+	int panX = 0; // Second view of the reuse check: moved by whole pixels ...
+	int panY = 0;
+	int zoomSteps = 0; // ... and zoomed in by this power of two (out if negative)
+	std::string tileReportPath;
+};
+
+static void printUsage() {
+	std::cout << "Usage: MandelbrotRender [options]" << std::endl
+		<< "  --width <pixels>        Image width (default 1080)" << std::endl
+		<< "  --height <pixels>       Image height (default 720)" << std::endl
+		<< "  --zoom <scale>          zoomScale, width of the view in the complex plane (default 3.5)" << std::endl
+		<< "  --real <start>          realPartStart, any number of digits (default -2.5)" << std::endl
+		<< "  --imag <start>          imagPartStart, any number of digits (default -1.75)" << std::endl
+		<< "  --iterations <count>    Max iterations (default: same automatic value as the app)" << std::endl
+		<< "  --color <rgb|bw|glow>   Color scheme (default rgb)" << std::endl
+		<< "  --output <file>         Output file, \".png\" writes a PNG, anything else a PPM (default mandelbrot.png)" << std::endl
+		<< "  --isa <auto|scalar|avx2|avx512>  Instruction set of the iteration kernel (default auto)" << std::endl
+		<< "  --kernel-mode <batched|streaming>  How SIMD lanes get their pixels (default streaming)" << std::endl
+		<< "  --algorithm <auto|direct|double-double|fixed-point|perturbation|bla>  Direct iteration in double, double-double or 64/128 bit fixed point, or perturbation against a reference orbit (bla: with bilinear approximation jumps) (default auto)" << std::endl
+		<< "  --series-terms <count>  Terms of the series approximation that lets perturbation pixels skip iterations, 0 disables it (default 6)" << std::endl
+		<< "  --reference <center|nucleus>  Reference orbit of perturbation frames: the view center, or the nucleus of the largest minibrot in view (default center)" << std::endl
+		<< "  --reference-memory <MiB>  Memory a reference orbit may take before it is stored compressed (default 1024)" << std::endl
+		<< "  --tile-cache <MiB>      Memory of the cache of computed tiles that later frames on the same lattice take points from, not used by perturbation, 0 disables it (default 256)" << std::endl
+		<< "  --threads <count>       Worker threads (default 0 = one per hardware thread)" << std::endl
+		<< "  --subdivide             Mariani-Silver: fill rectangles whose border has a single iteration count without iterating them" << std::endl
+		<< "  --prove-tiles           Fill tiles (or their quarters) that ball arithmetic proves to have a single iteration count, direct and double-double only" << std::endl
+		<< "  --distance-fill         Fill the pixels within the distance estimate of a computed interior pixel (with --color bw: of every computed pixel), direct only" << std::endl
+		<< "  --progressive           Render at 1/16, 1/4 and then full resolution, guessing pixels whose coarser neighbours agree" << std::endl
+		<< "  --tile-size <pixels>    Edge length of the tiles the workers take from their deques (default 64)" << std::endl
+		<< "  --tile-report <file>    Writes the timing of every tile as CSV" << std::endl
+		<< "  --bench                 Render with every supported instruction set and print Miter/s, writes no image" << std::endl
+		<< "  --bench-algorithms      Render with direct, double-double, fixed-point and perturbation and print their times, writes no image" << std::endl
+		<< "  --check-subdivision     Render with and without --subdivide and print how many filled pixels differ, writes no image" << std::endl
+		<< "  --check-pan <dx>,<dy>   Render, move the view by whole pixels reusing the frame, and print how many pixels differ from a fresh render, writes no image" << std::endl
+		<< "  --check-zoom <steps>    Same for zooming in by 2^steps around the center (out if negative), can be combined with --check-pan" << std::endl;
+}
+
+static bool parseColorType(const std::string& value, FlowColorType& colorType) {
+	if (value == "rgb")
+		colorType = FlowColorType::Rgb;
+	else if (value == "bw")
+		colorType = FlowColorType::BlackWhite;
+	else if (value == "glow")
+		colorType = FlowColorType::Glowing;
+	else
+		return false;
+	return true;
+}
+
+static bool parseIsa(const std::string& value, KernelIsa& isa) {
+	if (value == "auto")
+		isa = bestSupportedIsa();
+	else if (value == "scalar")
+		isa = KernelIsa::Scalar;
+	else if (value == "avx2")
+		isa = KernelIsa::Avx2;
+	else if (value == "avx512")
+		isa = KernelIsa::Avx512;
+	else
+		return false;
+	return true;
+}
+
+static bool parseKernelMode(const std::string& value, KernelMode& mode) {
+	if (value == "batched")
+		mode = KernelMode::Batched;
+	else if (value == "streaming")
+		mode = KernelMode::Streaming;
+	else
+		return false;
+	return true;
+}
+
+static bool parseAlgorithm(const std::string& value, RenderAlgorithm& algorithm) {
+	if (value == "auto")
+		algorithm = RenderAlgorithm::Auto;
+	else if (value == "direct")
+		algorithm = RenderAlgorithm::Direct;
+	else if (value == "perturbation")
+		algorithm = RenderAlgorithm::Perturbation;
+	else if (value == "bla")
+		algorithm = RenderAlgorithm::Bla;
+	else if (value == "double-double")
+		algorithm = RenderAlgorithm::DoubleDouble;
+	else if (value == "fixed-point")
+		algorithm = RenderAlgorithm::FixedPoint;
+	else
+		return false;
+	return true;
+}
+
+static bool writeTileReport(const std::string& path, const std::vector<TileReport>& reports) {
+	std::ofstream stream{path, std::ofstream::out | std::ofstream::trunc};
+	stream << "x,y,width,height,worker,milliseconds,iterations" << std::endl;
+	for (const TileReport& report : reports) {
+		stream << report.x << ',' << report.y << ',' << report.width << ',' << report.height << ',' << report.worker << ','
+			<< report.milliseconds << ',' << report.iterations << std::endl;
+	}
+	return static_cast<bool>(stream);
+}
+
+static void printTileSummary(const RenderStatistics& statistics, const std::vector<TileReport>& reports) {
+	if (reports.empty())
+		return;
+
+	std::vector<double> times;
+	for (const TileReport& report : reports)
+		times.push_back(report.milliseconds);
+	std::sort(times.begin(), times.end());
+
+	std::cout << statistics.tileCount << " tiles on " << statistics.threadCount << " threads, " << statistics.steals << " stolen, tile time min "
+		<< times.front() << " ms, median " << times[times.size() / 2] << " ms, max " << times.back() << " ms" << std::endl;
+}
+
+/**
+ * @return `view` zoomed in by 2^steps (out if negative) around its center pixel, on the same lattice
+ */
+static ViewState zoomOnLattice(const ViewState& view, int steps) {
+	ViewState zoomed = view;
+	zoomed.zoomScale = std::ldexp(view.zoomScale, -steps);
+	// Column x is lattice index x + panX + 1 and row y index height - y - panY, the center pixel keeps its point
+	std::int64_t centerX = view.width / 2;
+	std::int64_t centerY = view.height / 2;
+	std::int64_t columnIndex = centerX + view.panX + 1;
+	std::int64_t rowIndex = view.height - centerY - view.panY;
+	if (steps >= 0) {
+		columnIndex *= std::int64_t{1} << steps;
+		rowIndex *= std::int64_t{1} << steps;
+	}
+	else {
+		// Rounded down, a coarser lattice only has every 2^-steps th point
+		std::int64_t divisor = std::int64_t{1} << -steps;
+		columnIndex = (columnIndex - (columnIndex % divisor + divisor) % divisor) / divisor;
+		rowIndex = (rowIndex - (rowIndex % divisor + divisor) % divisor) / divisor;
+	}
+	zoomed.panX = columnIndex - centerX - 1;
+	zoomed.panY = view.height - centerY - rowIndex;
+	return zoomed;
+}
+
+static bool parseArguments(const std::vector<std::string>& arguments, CliOptions& options) {
+	for (std::size_t i = 0; i < arguments.size(); i++) {
+		const std::string& name = arguments[i];
+		if (name == "--help" || name == "-h")
+			return false;
+		if (name == "--bench") {
+			options.benchmark = true;
+			continue;
+		}
+		if (name == "--bench-algorithms") {
+			options.benchmarkAlgorithms = true;
+			continue;
+		}
+		if (name == "--subdivide") {
+			options.settings.rectangleSubdivision = true;
+			continue;
+		}
+		if (name == "--prove-tiles") {
+			options.settings.provenTiles = true;
+			continue;
+		}
+		if (name == "--distance-fill") {
+			options.settings.distanceFill = true;
+			continue;
+		}
+		if (name == "--progressive") {
+			options.settings.progressiveRefinement = true;
+			continue;
+		}
+		if (name == "--check-subdivision") {
+			options.checkSubdivision = true;
+			continue;
+		}
+
+		if (i + 1 >= arguments.size()) {
+			std::cout << "Missing value for " << name << std::endl;
+			return false;
+		}
+		const std::string& value = arguments[++i];
+
+		if (name == "--width")
+			options.view.width = std::stoi(value);
+		else if (name == "--height")
+			options.view.height = std::stoi(value);
+		else if (name == "--zoom")
+			options.view.zoomScale = std::stold(value);
+		else if (name == "--real")
+			options.view.realPartStart = BigFixed::fromString(value);
+		else if (name == "--imag")
+			options.view.imagPartStart = BigFixed::fromString(value);
+		else if (name == "--iterations") {
+			options.view.maxIterations = static_cast<unsigned int>(std::stoul(value));
+			options.autoIterations = false;
+		}
+		else if (name == "--color") {
+			if (!parseColorType(value, options.colorType)) {
+				std::cout << "Unknown color scheme: " << value << std::endl;
+				return false;
+			}
+		}
+		else if (name == "--output")
+			options.outputPath = value;
+		else if (name == "--threads")
+			options.settings.threadCount = static_cast<unsigned int>(std::stoul(value));
+		else if (name == "--series-terms")
+			options.settings.seriesTerms = static_cast<unsigned int>(std::stoul(value));
+		else if (name == "--reference") {
+			if (value != "center" && value != "nucleus") {
+				std::cout << "Unknown reference: " << value << std::endl;
+				return false;
+			}
+			options.settings.nucleusReference = value == "nucleus";
+		}
+		else if (name == "--reference-memory")
+			options.settings.referenceMemoryLimit = static_cast<std::size_t>(std::stoull(value)) << 20;
+		else if (name == "--tile-cache")
+			options.settings.tileCacheMemory = static_cast<std::size_t>(std::stoull(value)) << 20;
+		else if (name == "--check-pan") {
+			std::size_t comma = value.find(',');
+			if (comma == std::string::npos) {
+				std::cout << "Expected <dx>,<dy>: " << value << std::endl;
+				return false;
+			}
+			options.panX = std::stoi(value.substr(0, comma));
+			options.panY = std::stoi(value.substr(comma + 1));
+			options.checkReuse = true;
+		}
+		else if (name == "--check-zoom") {
+			options.zoomSteps = std::stoi(value);
+			options.checkReuse = true;
+		}
+		else if (name == "--tile-size")
+			options.settings.tileSize = std::stoi(value);
+		else if (name == "--tile-report")
+			options.tileReportPath = value;
+		else if (name == "--kernel-mode") {
+			if (!parseKernelMode(value, options.settings.kernelMode)) {
+				std::cout << "Unknown kernel mode: " << value << std::endl;
+				return false;
+			}
+		}
+		else if (name == "--algorithm") {
+			if (!parseAlgorithm(value, options.settings.algorithm)) {
+				std::cout << "Unknown algorithm: " << value << std::endl;
+				return false;
+			}
+		}
+		else if (name == "--isa") {
+			if (!parseIsa(value, options.settings.isa)) {
+				std::cout << "Unknown instruction set: " << value << std::endl;
+				return false;
+			}
+			if (!isIsaSupported(options.settings.isa))
+				std::cout << "Warning: " << value << " is not supported on this machine, using the scalar kernel" << std::endl;
+		}
+		else {
+			std::cout << "Unknown option: " << name << std::endl;
+			return false;
+		}
+	}
+
+	if (options.view.width <= 0 || options.view.height <= 0) {
+		std::cout << "Image size needs to be positive" << std::endl;
+		return false;
+	}
+	// Black/white only shows membership, so the distance fill may fill the exterior disks too
+	options.settings.membershipOnly = options.colorType == FlowColorType::BlackWhite;
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	CliOptions options;
+	try {
+		if (!parseArguments({argv + 1, argv + argc}, options)) {
+			printUsage();
+			return -1;
+		}
+	}
+	catch (const std::exception& exception) { // thrown by std::stoi and friends, and BigFixed::fromString
+		std::cout << "Invalid argument: " << exception.what() << std::endl;
+		printUsage();
+		return -1;
+	}
+
+	if (options.view.zoomScale < MIN_ZOOM_SCALE || std::ldexp(options.view.zoomScale, -options.zoomSteps) < MIN_ZOOM_SCALE) {
+		std::cout << "Zoom below " << MIN_ZOOM_SCALE << " is out of range of long double on this platform" << std::endl;
+		return -1;
+	}
+	if (options.autoIterations)
+		options.view.maxIterations = calcAutoMaxIterations(options.view.zoomScale);
+
+	RenderEngine engine{options.settings};
+
+	if (options.benchmark) {
+		for (const RenderStatistics& statistics : engine.benchmarkKernels(options.view)) {
+			std::cout << isaName(statistics.isa) << " " << kernelModeName(statistics.kernelMode) << ": " << statistics.megaIterationsPerSecond()
+				<< " Miter/s (" << statistics.seconds << " s, " << 100.0 * statistics.laneUtilization << "% lane utilization, "
+				<< statistics.threadCount << " threads)" << std::endl;
+		}
+		return 0;
+	}
+	if (options.benchmarkAlgorithms) {
+		for (const RenderStatistics& statistics : engine.benchmarkAlgorithms(options.view)) {
+			std::cout << renderAlgorithmName(statistics.algorithm);
+			if (statistics.fixedPointBits > 0)
+				std::cout << " (" << statistics.fixedPointBits << " bit)";
+			std::cout << " " << isaName(statistics.isa) << ": " << statistics.seconds << " s, " << statistics.megaIterationsPerSecond()
+				<< " Miter/s (" << statistics.threadCount << " threads)" << std::endl;
+		}
+		return 0;
+	}
+	if (options.checkSubdivision) {
+		SubdivisionCheck check = engine.checkSubdivision(options.view);
+		std::cout << "Subdivision filled " << check.filledPixels << " of " << check.pixels << " pixels ("
+			<< 100.0 * static_cast<double>(check.filledPixels) / static_cast<double>(check.pixels) << "%), " << check.wrongPixels
+			<< " differ from the full render (" << 100.0 * static_cast<double>(check.wrongPixels) / static_cast<double>(check.pixels) << "%)" << std::endl;
+		std::cout << "Subdivided " << check.subdividedSeconds << " s, full " << check.fullSeconds << " s" << std::endl;
+		return 0;
+	}
+
+	if (options.checkReuse) {
+		ViewState second = zoomOnLattice(options.view, options.zoomSteps);
+		second.panX += options.panX;
+		second.panY += options.panY;
+		if (options.autoIterations)
+			second.maxIterations = calcAutoMaxIterations(second.zoomScale);
+		ReuseCheck check = engine.checkReuse(options.view, second);
+		std::cout << "Reused " << check.reusedPixels << " of " << check.pixels << " pixels ("
+			<< 100.0 * static_cast<double>(check.reusedPixels) / static_cast<double>(check.pixels) << "%) and took "
+			<< check.cachedPixels << " from the tile cache, " << check.wrongPixels
+			<< " differ from the fresh render (" << 100.0 * static_cast<double>(check.wrongPixels) / static_cast<double>(check.pixels) << "%)" << std::endl;
+		std::cout << "Reusing " << check.reusingSeconds << " s (" << 100.0 * check.reusingSeconds / check.fullSeconds << "% of fresh), fresh " << check.fullSeconds << " s" << std::endl;
+		return 0;
+	}
+
+	RgbImage image = engine.renderImage(options.view, options.colorType);
+
+	const RenderStatistics& statistics = engine.getLastStatistics();
+	std::cout << "Rendered " << image.width << "x" << image.height << " with " << options.view.maxIterations << " max iterations in "
+		<< statistics.seconds << " s using " << isaName(statistics.isa) << " " << kernelModeName(statistics.kernelMode) << " ("
+		<< statistics.megaIterationsPerSecond() << " Miter/s, " << 100.0 * statistics.laneUtilization << "% lane utilization)" << std::endl;
+	if (statistics.algorithm == RenderAlgorithm::Bla) {
+		std::size_t totalBytes = 0;
+		for (std::size_t bytes : statistics.blaLevelBytes)
+			totalBytes += bytes;
+		std::cout << "BLA: reference orbit of " << statistics.referenceIterations << " iterations in " << statistics.referenceSeconds << " s, "
+			<< (statistics.referencePeriod > 0 ? "periodic nucleus, " : "")
+			<< statistics.blaLevelBytes.size() << " table levels using " << totalBytes / 1024 << " KiB" << std::endl;
+		for (std::size_t level = 0; level < statistics.blaLevelBytes.size(); level++)
+			std::cout << "  level " << level << " (" << (1u << level) << " iterations per step): " << statistics.blaLevelBytes[level] << " bytes" << std::endl;
+	}
+	if (statistics.algorithm == RenderAlgorithm::Perturbation) {
+		std::cout << "Perturbation: reference orbit of " << statistics.referenceIterations << " iterations in "
+			<< statistics.referenceSeconds << " s (" << statistics.referenceBytes / 1024 << " KiB" << (statistics.referenceCompressed ? ", compressed" : "")
+			<< (statistics.referencePeriod > 0 ? ", periodic nucleus" : "")
+			<< "), series approximation skipped " << statistics.seriesSkippedIterations
+			<< " iterations (error bound " << statistics.seriesErrorBound << ")" << std::endl;
+	}
+	if (statistics.algorithm == RenderAlgorithm::Perturbation) {
+		std::cout << "Glitches: " << statistics.glitchedPixels << " pixels, corrected in " << statistics.glitchPasses << " passes with "
+			<< statistics.glitchReferences << " extra references, " << statistics.remainingGlitches << " left" << std::endl;
+	}
+	if (statistics.algorithm == RenderAlgorithm::Direct) {
+		std::cout << "Interior: " << statistics.bulbPixels << " pixels in the cardioid or period-2 bulb, "
+			<< statistics.periodicPixels << " stopped as periodic" << std::endl;
+	}
+	if (options.settings.rectangleSubdivision)
+		std::cout << "Subdivision: " << statistics.filledPixels << " pixels filled without iterating" << std::endl;
+	if (options.settings.provenTiles) {
+		std::size_t pixels = static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
+		std::cout << "Proven: " << statistics.provenPixels << " of " << pixels << " pixels ("
+			<< 100.0 * static_cast<double>(statistics.provenPixels) / static_cast<double>(pixels) << "%) resolved by ball arithmetic" << std::endl;
+	}
+	if (options.settings.distanceFill) {
+		std::size_t pixels = static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
+		std::cout << "Distance fill: " << statistics.distancePixels << " of " << pixels << " pixels ("
+			<< 100.0 * static_cast<double>(statistics.distancePixels) / static_cast<double>(pixels) << "%) skipped" << std::endl;
+	}
+	if (options.settings.progressiveRefinement) {
+		std::size_t pixels = static_cast<std::size_t>(image.width) * static_cast<std::size_t>(image.height);
+		std::cout << "Progressive: " << statistics.guessedPixels << " of " << pixels << " pixels ("
+			<< 100.0 * static_cast<double>(statistics.guessedPixels) / static_cast<double>(pixels) << "%) guessed from their neighbours" << std::endl;
+	}
+	if (statistics.algorithm == RenderAlgorithm::FixedPoint)
+		std::cout << "Fixed point: " << statistics.fixedPointBits << " bit integers" << std::endl;
+	if (statistics.rescaledDeltas)
+		std::cout << "Deltas are below the range of double, iterated with a separate exponent" << std::endl;
+	printTileSummary(statistics, engine.getLastTileReports());
+
+	if (!options.tileReportPath.empty() && !writeTileReport(options.tileReportPath, engine.getLastTileReports()))
+		std::cout << "Failed to write " << options.tileReportPath << std::endl;
+
+	if (!writeImage(options.outputPath, image)) {
+		std::cout << "Failed to write " << options.outputPath << std::endl;
+		return -1;
+	}
+	return 0;
+}
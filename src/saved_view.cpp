@@ -1,5 +1,6 @@
 #include "saved_view.h"
 
+#include <algorithm>
 #include <chrono>
 
 // * static
@@ -15,7 +16,7 @@ void SavedView::initFromFile() {
 	}
 }
 
-void SavedView::saveNew(long double zoomScale, const ComplexNum& startNum, const std::string& name) {
+void SavedView::saveNew(long double zoomScale, const ComplexFixed& startNum, const std::string& name) {
 	allViews.push_back(SavedView{zoomScale, startNum, name});
 	const SavedView& currentElement = *(allViews.cend() - 1);
 	iniFile.set(currentElement.imGuiIDs[0], currentElement.viewDataToString());
@@ -59,7 +60,7 @@ int SavedView::createNewID() const {
 	return newID;
 }
 
-SavedView::SavedView(long double zoomScale, const ComplexNum& startNum, const std::string& name)
+SavedView::SavedView(long double zoomScale, const ComplexFixed& startNum, const std::string& name)
     : zoomScale(zoomScale), startNum(startNum), name(name)
 {
     if (name.empty())
@@ -70,7 +71,7 @@ SavedView::SavedView(long double zoomScale, const ComplexNum& startNum, const st
 }
 
 SavedView::SavedView(int firstID, const std::string& viewData) {
-	// Format: "name|zoomScale|startNum.first|startNum.second|imGuiIds[1]|...|imGuiIds['last']|"
+	// Format: "name|zoomScale|startNum.real|startNum.imag|imGuiIds[1]|...|imGuiIds['last']|"
 	std::string value;
 	std::stringstream stream{viewData};
 
@@ -81,11 +82,12 @@ SavedView::SavedView(int firstID, const std::string& viewData) {
 	std::getline(stream, value, '|');
 	zoomScale = std::stold(value);
 
+	// Older files hold long double values here, `BigFixed` reads them just as well
 	std::getline(stream, value, '|');
-	startNum.first = std::stold(value);
+	startNum.real = BigFixed::fromString(value);
 
 	std::getline(stream, value, '|');
-	startNum.second = std::stold(value);
+	startNum.imag = BigFixed::fromString(value);
 
 	for (int i = 0; std::getline(stream, value, '|'); i++)
 		imGuiIDs[i + 1] = std::stoi(value);
@@ -94,15 +96,15 @@ SavedView::SavedView(int firstID, const std::string& viewData) {
 std::string SavedView::createGenericName() const {
     std::stringstream stream;
     stream.precision(5);
-    stream << startNum.first + 0.5L * zoomScale << " + " << startNum.second + 0.5L * zoomScale << " i (" << zoomScale << ")";
+    stream << startNum.real.toLongDouble() + 0.5L * zoomScale << " + " << startNum.imag.toLongDouble() + 0.5L * zoomScale << " i (" << zoomScale << ")";
     return stream.str();
 }
 
 std::string SavedView::viewDataToString() const {
-	// Format: "name|zoomScale|startNum.first|startNum.second|imGuiIds[1]|...|imGuiIds['last']|"
+	// Format: "name|zoomScale|startNum.real|startNum.imag|imGuiIds[1]|...|imGuiIds['last']|"
 	std::stringstream stream;
 	stream.precision(std::numeric_limits<long double>::max_digits10);
-	stream << name << '|' << zoomScale << '|' << startNum.first << '|' << startNum.second << '|';
+	stream << name << '|' << zoomScale << '|' << startNum.real.toString() << '|' << startNum.imag.toString() << '|';
 	for (int i = 1; i < imGuiIDs.size(); i++)
 		stream << imGuiIDs[i] << '|';
 	return stream.str();
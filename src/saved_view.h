@@ -10,6 +10,7 @@
 
 #include "app_utility.h"
 #include "ini_file.h"
+#include "core/big_fixed.h"
 
 class SavedView {
 
@@ -19,7 +20,7 @@ public:
     using IDsList_t = std::array<int, NUMBER_OF_IDS>;
     static std::vector<SavedView> allViews;
     static void initFromFile();
-    static void saveNew(long double zoomScale, const ComplexNum& startNum, const std::string& name = "");
+    static void saveNew(long double zoomScale, const ComplexFixed& startNum, const std::string& name = "");
     static void removeSavedView(const SavedView& savedView);
     
 protected:
@@ -29,13 +30,13 @@ protected:
 // * non-static
 protected:
 	long double zoomScale;
-	ComplexNum startNum;
+	ComplexFixed startNum; // realPartStart and imagPartStart, stored with all their digits
     std::string name;
 	IDsList_t imGuiIDs; // -1 is an invalid id
 
 public:
     inline long double getZoomScale() const { return zoomScale; }
-    inline const ComplexNum& getStartNum() const { return startNum; }
+    inline const ComplexFixed& getStartNum() const { return startNum; }
     inline const std::string& getName() const { return name; }
     inline const IDsList_t& getImGuiIDs() const { return imGuiIDs; }
 
@@ -44,7 +45,7 @@ public:
     auto operator<=>(const SavedView& other) const = default;
 
 protected:
-    SavedView(long double zoomScale, const ComplexNum& startNum, const std::string& name = "");
+    SavedView(long double zoomScale, const ComplexFixed& startNum, const std::string& name = "");
     SavedView(int firstID, const std::string& viewData);
     std::string createGenericName() const;
     int createNewID() const;